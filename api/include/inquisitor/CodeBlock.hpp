@@ -0,0 +1,102 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include <inquisitor/CoreDependencies.hpp>
+
+// Language tag of a code block, usable as a template argument
+template<std::size_t N>
+struct CodeBlockLanguage {
+    constexpr CodeBlockLanguage(const char (&language)[N]) noexcept {
+        std::ranges::copy(language, std::ranges::begin(data));
+    }
+
+    [[nodiscard]] constexpr auto view() const noexcept -> std::string_view {
+        return std::string_view { data, N - 1 };
+    }
+
+    char data[N] {};
+};
+
+// Finds the first markdown code block tagged with Language, built at compile time. Same matches
+// as the std::regex "```<language>\n([<body characters>]+)\n```" with the icase flag, but the body
+// is returned as a view on the message and nothing is allocated:
+//
+//     static constexpr auto GLSL = CodeBlock<"glsl"> {};
+//
+//     if (const auto body = GLSL.find(message.content); body) compile(*body);
+template<CodeBlockLanguage Language>
+class CodeBlock {
+  public:
+    [[nodiscard]] static constexpr auto find(std::string_view text) noexcept
+        -> std::optional<std::string_view> {
+        constexpr auto FENCE   = std::string_view { "```" };
+        constexpr auto OPENING = std::size(FENCE) + std::size(Language.view()) + 1;
+
+        auto position = std::size_t { 0 };
+        while (position < std::size(text)) {
+            position = text.find(FENCE, position);
+            if (position == std::string_view::npos) return std::nullopt;
+
+            if (!isOpening(text.substr(position, OPENING))) {
+                ++position;
+                continue;
+            }
+
+            // the body can't contain a backtick, so it only ends on the first character outside
+            // of the class, which has to be the closing fence preceded by a newline
+            const auto begin = position + OPENING;
+            auto end         = begin;
+            while (end < std::size(text) && BODY[static_cast<unsigned char>(text[end])]) ++end;
+
+            if (end - begin >= 2 && text[end - 1] == '\n' && text.substr(end, 3) == FENCE)
+                return text.substr(begin, end - begin - 1);
+
+            position = end;
+        }
+
+        return std::nullopt;
+    }
+
+    [[nodiscard]] constexpr auto operator()(std::string_view text) const noexcept
+        -> std::optional<std::string_view> {
+        return find(text);
+    }
+
+  private:
+    static constexpr auto BODY = [] {
+        auto table = std::array<bool, 256> {};
+
+        for (auto c = 'a'; c <= 'z'; ++c) table[static_cast<unsigned char>(c)] = true;
+        for (auto c = 'A'; c <= 'Z'; ++c) table[static_cast<unsigned char>(c)] = true;
+        for (auto c = '0'; c <= '9'; ++c) table[static_cast<unsigned char>(c)] = true;
+        for (auto c : std::string_view { "\n\r\t^,:{}[]-.+=*$&_%?/\" ();<>!" })
+            table[static_cast<unsigned char>(c)] = true;
+
+        return table;
+    }();
+
+    [[nodiscard]] static constexpr auto toLower(char c) noexcept -> char {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    [[nodiscard]] static constexpr auto isOpening(std::string_view candidate) noexcept -> bool {
+        constexpr auto LANGUAGE = Language.view();
+
+        if (std::size(candidate) != std::size(LANGUAGE) + 4) return false;
+        if (candidate.back() != '\n') return false;
+
+        for (auto i = 0u; i < std::size(LANGUAGE); ++i)
+            if (toLower(candidate[i + 3]) != toLower(LANGUAGE[i])) return false;
+
+        return true;
+    }
+};
+
+static_assert(CodeBlock<"glsl">::find("```glsl\nvoid main() {}\n```") == "void main() {}");
+static_assert(CodeBlock<"glsl">::find("look ```GLSL\nx\n``` there") == "x");
+static_assert(!CodeBlock<"glsl">::find("```glsl\n\n```"));
+static_assert(!CodeBlock<"glsl">::find("```json\n{}\n```"));
+static_assert(CodeBlock<"json">::find("```json\n`\n``` ```json\n{}\n```") == "{}");
@@ -0,0 +1,88 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include <inquisitor/CoreDependencies.hpp>
+#include <inquisitor/MessageScanner.hpp>
+
+// Services owned by the core and shared by every loaded plugin
+class CoreServices {
+  public:
+    using Resumer    = std::move_only_function<void(std::coroutine_handle<>)>;
+    using Completion = dpp::command_completion_event_t;
+    using Request    = std::move_only_function<void(Completion)>;
+
+    // outbound requests are sent by class, a housekeeping burst never delays interaction replies
+    enum class Priority {
+        INTERACTION,
+        REPLY,
+        HOUSEKEEPING,
+    };
+
+    struct DownloadRequest {
+        // called on the download thread for every received chunk, returning false aborts the
+        // transfer. The body isn't kept when set
+        using OnData = std::move_only_function<bool(std::string_view)>;
+
+        std::string url;
+        // 0 uses the limits of the downloads settings, they can only be lowered
+        std::size_t max_size              = 0;
+        std::chrono::milliseconds timeout = std::chrono::milliseconds { 0 };
+        OnData on_data                    = {};
+    };
+
+    struct DownloadResult {
+        // 0 if no response was received
+        long status = 0;
+        // sized from Content-Length upfront when the server sends it, empty when streamed
+        std::string body;
+        // received bytes, streamed or not
+        std::size_t size = 0;
+        // empty on success
+        std::string error;
+
+        [[nodiscard]] auto ok() const noexcept -> bool {
+            return std::empty(error) && status >= 200 && status < 300;
+        }
+    };
+
+    virtual ~CoreServices() = 0;
+
+    // registrations are only taken into account when done from PluginInterface::initialize()
+    [[nodiscard]] virtual auto messageScanner() noexcept -> MessageScanner & = 0;
+
+    // resumes a suspended coroutine on the executor of the calling plugin thread
+    [[nodiscard]] virtual auto resumer() -> Resumer = 0;
+
+    // sends a request issued through restCall(). name identifies the request in traces and its
+    // rate limit route, major is the channel, guild or webhook id the route is split by, if any.
+    // An offline replay completes it in process with an empty value of the type the request of
+    // that name returns, or an error for a name it doesn't know
+    virtual auto sendRequest(std::string_view name,
+                             Priority priority,
+                             Request request,
+                             Completion on_completion,
+                             dpp::snowflake major = {}) -> void = 0;
+
+    // messages seen on the gateway and the ones given to cacheMessage(), nullptr on a miss. Edited
+    // and deleted messages are dropped from the cache
+    [[nodiscard]] virtual auto cachedMessage(dpp::snowflake id)
+        -> std::shared_ptr<const dpp::message> = 0;
+    virtual auto cacheMessage(const dpp::message &message) -> void = 0;
+
+    // answers the interaction with a channel message, failures are logged by the core
+    virtual auto reply(const dpp::interaction_create_t &event, dpp::message message) -> void = 0;
+
+    // buffered for a short window and merged with the other deletes of the channel into bulk
+    // deletes, failures are logged by the core
+    virtual auto deleteMessage(dpp::snowflake id, dpp::snowflake channel_id) -> void = 0;
+    // a reaction already added to the message recently is dropped
+    virtual auto addReaction(const dpp::message &message, std::string_view emoji) -> void = 0;
+
+    // queued to the core downloader, which keeps the connections alive across the requests of
+    // every plugin. Start every download before waiting on the first future so they run in
+    // parallel
+    [[nodiscard]] virtual auto download(DownloadRequest request) -> std::future<DownloadResult> = 0;
+};
@@ -0,0 +1,96 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include <inquisitor/CoreDependencies.hpp>
+
+// Scans every received message once for the patterns registered by all the plugins.
+// Literals (keywords and url schemes) are compiled into a single Aho-Corasick automaton with a
+// dense transition table, urls and discord message links are then validated from the scheme hit.
+class MessageScanner {
+  public:
+    using KeywordID = stormkit::core::UInt32;
+
+    enum Features : stormkit::core::UInt8 {
+        NONE          = 0,
+        URLS          = 1 << 0,
+        MESSAGE_LINKS = 1 << 1,
+    };
+
+    struct Keyword {
+        KeywordID id;
+        std::string_view span;
+    };
+
+    struct MessageLink {
+        std::string_view span;
+        dpp::snowflake guild_id;
+        dpp::snowflake channel_id;
+        dpp::snowflake message_id;
+    };
+
+    struct Matches {
+        Matches() noexcept = default;
+        explicit Matches(std::pmr::memory_resource *resource) noexcept
+            : keywords { resource }, urls { resource }, message_links { resource } {}
+
+        std::pmr::vector<Keyword> keywords;
+        std::pmr::vector<std::string_view> urls;
+        std::pmr::vector<MessageLink> message_links;
+
+        [[nodiscard]] auto contains(KeywordID id) const noexcept -> bool {
+            return std::ranges::any_of(keywords, [id](const auto &k) { return k.id == id; });
+        }
+    };
+
+    MessageScanner() noexcept;
+    ~MessageScanner();
+
+    MessageScanner(const MessageScanner &);
+    auto operator=(const MessageScanner &) -> MessageScanner &;
+
+    MessageScanner(MessageScanner &&) noexcept;
+    auto operator=(MessageScanner &&) noexcept -> MessageScanner &;
+
+    // keywords are matched case insensitively (ASCII only)
+    [[nodiscard]] auto addKeyword(std::string_view keyword) -> KeywordID;
+    auto enable(Features features) -> void;
+
+    // the next addKeyword() returns this id
+    [[nodiscard]] auto nextKeyword() const noexcept -> KeywordID { return m_next_keyword; }
+    [[nodiscard]] auto features() const noexcept -> Features {
+        return static_cast<Features>(m_features);
+    }
+    // the other keywords keep their id, both apply on the next compile()
+    auto eraseKeywords(KeywordID first, KeywordID last) -> void;
+    auto disable(Features features) -> void;
+
+    auto compile() -> void;
+
+    [[nodiscard]] auto scan(std::string_view text) const -> Matches;
+    auto scan(std::string_view text, Matches &matches) const -> void;
+
+  private:
+    using State = stormkit::core::UInt32;
+
+    struct Literal {
+        std::string text;
+        KeywordID keyword;
+    };
+
+    static constexpr auto URL_SCHEME = std::numeric_limits<KeywordID>::max();
+
+    auto matchUrl(std::string_view text, std::size_t begin, Matches &matches) const -> std::size_t;
+
+    stormkit::core::UInt8 m_features = NONE;
+
+    std::vector<Literal> m_keywords;
+    KeywordID m_next_keyword = 0;
+
+    std::vector<Literal> m_literals;
+
+    std::vector<std::array<State, 256>> m_transitions;
+    std::vector<std::vector<stormkit::core::UInt32>> m_outputs;
+};
@@ -0,0 +1,43 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include <inquisitor/CoreDependencies.hpp>
+#include <inquisitor/MessageScanner.hpp>
+
+// Built once by the core for every dispatched message and shared by all the plugins receiving
+// it. The views point into the message owned by the event, reading them never allocates
+struct MessageView {
+    struct Attachment {
+        dpp::snowflake id;
+        std::string_view filename;
+        std::string_view content_type;
+        std::string_view url;
+        stormkit::core::UInt32 size;
+    };
+
+    dpp::snowflake id;
+    dpp::snowflake channel_id;
+    dpp::snowflake guild_id;
+    dpp::snowflake author_id;
+
+    std::string_view content;
+    // the guild nickname if the author has one, the username otherwise
+    std::string_view author_name;
+
+    std::span<const Attachment> attachments;
+
+    // urls are only detected once a plugin enabled MessageScanner::URLS
+    bool has_url;
+    bool own_message;
+
+    const MessageScanner::Matches *matches;
+    // the full dpp event, for what the view doesn't carry
+    const dpp::message_create_t *event;
+
+    // monotonic scratch memory of this plugin callback, released at once when the returned task
+    // completes. Meant for std::pmr containers which don't outlive the callback
+    std::pmr::memory_resource *scratch;
+};
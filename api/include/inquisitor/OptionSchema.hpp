@@ -0,0 +1,113 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include <inquisitor/CoreDependencies.hpp>
+
+class InvalidOptions: public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+// Sorted snowflakes, contains() is a binary search over integers
+class SnowflakeSet {
+  public:
+    SnowflakeSet() noexcept = default;
+    explicit SnowflakeSet(std::vector<dpp::snowflake> ids);
+
+    [[nodiscard]] auto contains(dpp::snowflake id) const noexcept -> bool;
+
+    [[nodiscard]] auto empty() const noexcept -> bool { return std::empty(m_ids); }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return std::size(m_ids); }
+    [[nodiscard]] auto begin() const noexcept { return std::cbegin(m_ids); }
+    [[nodiscard]] auto end() const noexcept { return std::cend(m_ids); }
+
+    [[nodiscard]] auto ids() const noexcept -> const std::vector<dpp::snowflake> & { return m_ids; }
+
+  private:
+    std::vector<dpp::snowflake> m_ids;
+};
+
+// Options a plugin reads from its settings.json entry, each bound to the member it is parsed
+// into. apply() validates every option before assigning any, a bad entry leaves the plugin as
+// it was. Snowflakes are accepted as strings or numbers, durations as seconds or as a string
+// with a s / min / h / d suffix
+class OptionSchema {
+  public:
+    using json = nlohmann::json;
+
+    enum class Presence {
+        REQUIRED,
+        // the member keeps its value when the option is missing
+        OPTIONAL,
+    };
+
+    auto snowflake(std::string name, dpp::snowflake &target, Presence presence = Presence::REQUIRED)
+        -> OptionSchema &;
+    auto snowflakes(std::string name, SnowflakeSet &target, Presence presence = Presence::REQUIRED)
+        -> OptionSchema &;
+    auto string(std::string name, std::string &target, Presence presence = Presence::REQUIRED)
+        -> OptionSchema &;
+    auto strings(std::string name,
+                 std::vector<std::string> &target,
+                 Presence presence = Presence::REQUIRED) -> OptionSchema &;
+    auto duration(std::string name,
+                  std::chrono::seconds &target,
+                  Presence presence = Presence::REQUIRED) -> OptionSchema &;
+    auto boolean(std::string name, bool &target, Presence presence = Presence::REQUIRED)
+        -> OptionSchema &;
+
+    template<typename T>
+        requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+    auto number(std::string name,
+                T &target,
+                Presence presence = Presence::REQUIRED,
+                T min             = std::numeric_limits<T>::lowest(),
+                T max             = std::numeric_limits<T>::max()) -> OptionSchema &;
+
+    // throws InvalidOptions listing every invalid option
+    auto validate(const json &options) const -> void;
+    auto apply(const json &options) const -> void;
+
+    [[nodiscard]] auto empty() const noexcept -> bool { return std::empty(m_options); }
+
+  private:
+    using Commit = std::function<void()>;
+    // throws std::invalid_argument
+    using Parse = std::function<Commit(const json &)>;
+
+    struct Option {
+        std::string name;
+        Presence presence;
+        Parse parse;
+    };
+
+    auto add(std::string name, Presence presence, Parse parse) -> OptionSchema &;
+    auto parse(const json &options) const -> std::vector<Commit>;
+
+    std::vector<Option> m_options;
+};
+
+/////////////////////////////////////
+/////////////////////////////////////
+template<typename T>
+    requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+auto OptionSchema::number(std::string name, T &target, Presence presence, T min, T max)
+    -> OptionSchema & {
+    return add(std::move(name), presence, [&target, min, max](const json &value) -> Commit {
+        if (!value.is_number() || (std::is_integral_v<T> && !value.is_number_integer()))
+            throw std::invalid_argument { std::is_integral_v<T> ? "expected an integer"
+                                                                 : "expected a number" };
+
+        if (std::is_unsigned_v<T> && !value.is_number_unsigned())
+            throw std::invalid_argument { "expected a positive integer" };
+
+        const auto number = value.get<T>();
+        if (number < min || number > max)
+            throw std::invalid_argument { std::format("{} is out of [{}, {}]", number, min, max) };
+
+        return [&target, number] { target = number; };
+    });
+}
@@ -5,6 +5,11 @@
 #pragma once
 
 #include <inquisitor/CoreDependencies.hpp>
+#include <inquisitor/CoreServices.hpp>
+#include <inquisitor/MessageView.hpp>
+#include <inquisitor/OptionSchema.hpp>
+#include <inquisitor/RestCall.hpp>
+#include <inquisitor/Task.hpp>
 
 class PluginInterface {
   public:
@@ -45,22 +50,88 @@ class PluginInterface {
         std::string_view description;
     };
 
+    struct Subscription {
+        enum Events : stormkit::core::UInt8 {
+            NONE    = 0,
+            READY   = 1 << 0,
+            MESSAGE = 1 << 1,
+            ALL     = READY | MESSAGE,
+        };
+
+        stormkit::core::UInt8 events = ALL;
+
+        // std::nullopt means no filtering, an empty list means no channel / guild at all
+        std::optional<std::vector<dpp::snowflake>> channels = std::nullopt;
+        std::optional<std::vector<dpp::snowflake>> guilds   = std::nullopt;
+
+        bool ignore_own_messages = false;
+    };
+
+    // dpp caches read through dpp::find_*(), the core disables the ones no plugin reads unless
+    // settings.json says otherwise. Guilds and channels are always cached
+    struct Caches {
+        enum Entities : stormkit::core::UInt8 {
+            NONE   = 0,
+            USERS  = 1 << 0,
+            ROLES  = 1 << 1,
+            EMOJIS = 1 << 2,
+        };
+    };
+
     PluginInterface() noexcept;
     virtual ~PluginInterface() = 0;
 
-    void initialize(const json &options, std::vector<const PluginInterface *> others);
+    // heavy setup which doesn't need the options (devices, data files). Called once on the plugin
+    // executor right after loading, while the gateway connects, initialize() and the callbacks of
+    // the plugin are queued behind it
+    virtual auto prepare() -> void {}
+
+    // applies the options before calling initialize(options)
+    void initialize(const json &options,
+                    std::vector<const PluginInterface *> others,
+                    CoreServices &core);
+
+    // both throw InvalidOptions, applyOptions() leaves the bound members untouched then
+    auto validateOptions(const json &options) -> void;
+    auto applyOptions(const json &options) -> void;
 
     [[nodiscard]] virtual auto name() const -> const std::string      & = 0;
+    // may be queried before initialize(), the commands are registered without waiting for the
+    // plugins to be initialized
     [[nodiscard]] virtual auto commands() const -> std::vector<Command> = 0;
+    [[nodiscard]] virtual auto subscription() const -> Subscription { return {}; }
+    // gateway intents (dpp::intents) the plugin relies on, the core connects with the union of
+    // the intents of every enabled plugin. Queried once before initialize(), defaults to what
+    // subscription() may need
+    [[nodiscard]] virtual auto intents() const -> stormkit::core::UInt32;
+    // Caches::Entities, queried once before initialize()
+    [[nodiscard]] virtual auto caches() const -> stormkit::core::UInt8 { return Caches::NONE; }
     virtual auto onCommand([[maybe_unused]] const dpp::interaction_create_t &,
-                           [[maybe_unused]] dpp::cluster &) -> void {};
+                           [[maybe_unused]] dpp::cluster &) -> Task<> {
+        return {};
+    };
 
     virtual auto onReady([[maybe_unused]] const dpp::ready_t &, [[maybe_unused]] dpp::cluster &)
         -> void {};
+    // called on the plugin executor when its settings.json entry changed, after the described
+    // options were applied. subscription() and commands() are queried again afterward
+    virtual auto onConfigChanged([[maybe_unused]] const json &old_options,
+                                 [[maybe_unused]] const json &new_options) -> void {};
     virtual auto onMessageReceived([[maybe_unused]] const dpp::message_create_t &,
-                                   [[maybe_unused]] dpp::cluster &) -> void {}
+                                   [[maybe_unused]] const MessageScanner::Matches &,
+                                   [[maybe_unused]] dpp::cluster &) -> Task<> {
+        return {};
+    }
+    // called by the core for every received message, the view stays valid until the returned
+    // task completes. Forwards to onMessageReceived() unless overridden
+    virtual auto onMessage(const MessageView &message, dpp::cluster &bot) -> Task<> {
+        return onMessageReceived(*message.event, *message.matches, bot);
+    }
 
   protected:
+    // binds the plugin options to the members they are parsed into, the core validates them
+    // before the plugin is initialized and before a settings reload is applied
+    virtual auto describeOptions([[maybe_unused]] OptionSchema &schema) -> void {};
     virtual auto initialize([[maybe_unused]] const json &options) -> void {};
 
     SendMessageFunction sendMessage;
@@ -74,13 +145,20 @@ class PluginInterface {
 
     GetHttpFile getHttpFile;
 
+    // only valid during initialize(), plugins may be reloaded afterward
     std::vector<const PluginInterface *> m_others;
+
+    CoreServices *m_core = nullptr;
 };
 
+// pluginName() lets the core skip disabled plugins without constructing them, it must match
+// name(). A <library name>.json sidecar manifest ({ "name": "..." }) avoids even the dlopen
 #define INQUISITOR_PLUGIN(type)                                                \
     extern "C" {                                                               \
+    STORMKIT_EXPORT [[nodiscard]] auto pluginName() -> const char *;           \
     STORMKIT_EXPORT [[nodiscard]] auto allocatePlugin() -> type *;             \
     STORMKIT_EXPORT [[nodiscard]] auto deallocatePlugin(type *plugin) -> void; \
     }                                                                          \
+    auto pluginName()->const char * { return #type; }                          \
     auto allocatePlugin()->type * { return new type {}; }                      \
     auto deallocatePlugin(type *plugin)->void { delete plugin; }
@@ -0,0 +1,98 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include <inquisitor/CoreDependencies.hpp>
+#include <inquisitor/CoreServices.hpp>
+
+// Awaitable REST request. The request is sent as soon as the RestCall is constructed, so several
+// calls can be in flight before the first co_await:
+//
+//     auto channel = restCall(*m_core, "channel_get", [&](auto callback) {
+//         bot.channel_get(id, callback);
+//     });
+//     auto message = restCall(*m_core, "message_get", [&](auto callback) {
+//         bot.message_get(id, ch, callback);
+//     });
+//     const auto &channel_result = co_await channel;
+//     const auto &message_result = co_await message;
+//
+// The awaiting coroutine is resumed on the executor of the plugin that awaited it. Requests are
+// sent with the REPLY priority unless stated otherwise.
+class RestCall {
+  public:
+    template<typename Issue>
+    RestCall(CoreServices &core,
+             std::string_view name,
+             CoreServices::Priority priority,
+             Issue &&issue)
+        : m_core { &core }, m_state { std::make_shared<State>() } {
+        core.sendRequest(name,
+                         priority,
+                         std::forward<Issue>(issue),
+                         CoreServices::Completion { [state = m_state](const auto &result) {
+                             auto lock = std::unique_lock { state->mutex };
+                             state->result.emplace(result);
+
+                             auto waiter  = std::exchange(state->waiter, {});
+                             auto resumer = std::move(state->resumer);
+                             lock.unlock();
+
+                             if (waiter) resumer(waiter);
+                         } });
+    }
+
+    [[nodiscard]] auto await_ready() const -> bool {
+        auto lock = std::unique_lock { m_state->mutex };
+
+        return m_state->result.has_value();
+    }
+
+    auto await_suspend(std::coroutine_handle<> waiter) -> bool {
+        auto resumer = m_core->resumer();
+
+        auto lock = std::unique_lock { m_state->mutex };
+        if (m_state->result) return false;
+
+        m_state->waiter  = waiter;
+        m_state->resumer = std::move(resumer);
+
+        return true;
+    }
+
+    [[nodiscard]] auto await_resume() -> dpp::confirmation_callback_t {
+        return std::move(*m_state->result);
+    }
+
+  private:
+    struct State {
+        std::mutex mutex;
+        std::optional<dpp::confirmation_callback_t> result;
+
+        std::coroutine_handle<> waiter;
+        CoreServices::Resumer resumer;
+    };
+
+    CoreServices *m_core;
+    std::shared_ptr<State> m_state;
+};
+
+template<typename Issue>
+[[nodiscard]] auto restCall(CoreServices &core,
+                            std::string_view name,
+                            CoreServices::Priority priority,
+                            Issue &&issue) -> RestCall {
+    return RestCall { core, name, priority, std::forward<Issue>(issue) };
+}
+
+template<typename Issue>
+[[nodiscard]] auto restCall(CoreServices &core, std::string_view name, Issue &&issue) -> RestCall {
+    return RestCall { core, name, CoreServices::Priority::REPLY, std::forward<Issue>(issue) };
+}
+
+template<typename Issue>
+[[nodiscard]] auto restCall(CoreServices &core, Issue &&issue) -> RestCall {
+    return RestCall { core, "rest", CoreServices::Priority::REPLY, std::forward<Issue>(issue) };
+}
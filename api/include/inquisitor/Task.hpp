@@ -0,0 +1,129 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include <inquisitor/CoreDependencies.hpp>
+
+// Lazily started coroutine, either awaited by another Task or detached by the core which then
+// keeps the event alive until the coroutine completes
+template<typename T = void>
+class [[nodiscard]] Task {
+  public:
+    using ErrorHandler = std::move_only_function<void(std::exception_ptr)>;
+
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct PromiseBase {
+        struct FinalAwaiter {
+            [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(Handle handle) noexcept -> std::coroutine_handle<> {
+                auto &promise = handle.promise();
+                if (promise.continuation) return promise.continuation;
+
+                if (promise.detached) {
+                    if (promise.exception && promise.on_error) promise.on_error(promise.exception);
+
+                    handle.destroy();
+                }
+
+                return std::noop_coroutine();
+            }
+
+            auto await_resume() const noexcept -> void {}
+        };
+
+        [[nodiscard]] auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+        [[nodiscard]] auto final_suspend() const noexcept -> FinalAwaiter { return {}; }
+
+        auto unhandled_exception() noexcept -> void { exception = std::current_exception(); }
+
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        bool detached = false;
+        std::shared_ptr<const void> keep_alive;
+        ErrorHandler on_error;
+    };
+
+    struct ValuePromise: PromiseBase {
+        template<typename U>
+        auto return_value(U &&value) -> void {
+            result.emplace(std::forward<U>(value));
+        }
+
+        std::optional<T> result;
+    };
+
+    struct VoidPromise: PromiseBase {
+        auto return_void() noexcept -> void {}
+    };
+
+    struct promise_type: std::conditional_t<std::is_void_v<T>, VoidPromise, ValuePromise> {
+        [[nodiscard]] auto get_return_object() noexcept -> Task {
+            return Task { Handle::from_promise(*this) };
+        }
+    };
+
+    Task() noexcept = default;
+    ~Task() {
+        if (m_handle) m_handle.destroy();
+    }
+
+    Task(const Task &)                    = delete;
+    auto operator=(const Task &) -> Task & = delete;
+
+    Task(Task &&other) noexcept : m_handle { std::exchange(other.m_handle, {}) } {}
+    auto operator=(Task &&other) noexcept -> Task & {
+        if (this == &other) return *this;
+
+        if (m_handle) m_handle.destroy();
+        m_handle = std::exchange(other.m_handle, {});
+
+        return *this;
+    }
+
+    // starts the coroutine and gives it ownership of its frame, keep_alive is released once it
+    // completes
+    auto detach(std::shared_ptr<const void> keep_alive = nullptr, ErrorHandler on_error = nullptr)
+        && -> void {
+        if (!m_handle) return;
+
+        auto handle = std::exchange(m_handle, {});
+
+        auto &promise      = handle.promise();
+        promise.detached   = true;
+        promise.keep_alive = std::move(keep_alive);
+        promise.on_error   = std::move(on_error);
+
+        handle.resume();
+    }
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return !m_handle || m_handle.done(); }
+
+    auto await_suspend(std::coroutine_handle<> awaiting) noexcept -> std::coroutine_handle<> {
+        m_handle.promise().continuation = awaiting;
+
+        return m_handle;
+    }
+
+    auto await_resume() -> T {
+        if constexpr (std::is_void_v<T>) {
+            if (m_handle && m_handle.promise().exception)
+                std::rethrow_exception(m_handle.promise().exception);
+        } else {
+            auto &promise = m_handle.promise();
+            if (promise.exception) std::rethrow_exception(promise.exception);
+
+            return std::move(*promise.result);
+        }
+    }
+
+  private:
+    explicit Task(Handle handle) noexcept : m_handle { handle } {}
+
+    Handle m_handle;
+};
@@ -0,0 +1,9 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include <inquisitor/CoreServices.hpp>
+
+/////////////////////////////////////
+/////////////////////////////////////
+CoreServices::~CoreServices() = default;
@@ -0,0 +1,274 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include <inquisitor/MessageScanner.hpp>
+
+using namespace std::literals;
+using namespace stormkit;
+
+namespace {
+    using CharClass = std::array<bool, 256>;
+
+    constexpr auto makeCharClass(std::string_view extra) noexcept -> CharClass {
+        auto char_class = CharClass {};
+
+        for (auto c = 'a'; c <= 'z'; ++c) char_class[static_cast<core::UInt8>(c)] = true;
+        for (auto c = 'A'; c <= 'Z'; ++c) char_class[static_cast<core::UInt8>(c)] = true;
+        for (auto c = '0'; c <= '9'; ++c) char_class[static_cast<core::UInt8>(c)] = true;
+        for (auto c : extra) char_class[static_cast<core::UInt8>(c)] = true;
+
+        return char_class;
+    }
+
+    // same character classes as the url regex previously used by GalleryPlugin and
+    // GameOctoberPlugin: https?://(www\.)?[HOST]{1,256}\.[TLD]{1,6}\b([PATH]*)
+    constexpr auto HOST_CHARS = makeCharClass("-@:%._+~#=");
+    constexpr auto TLD_CHARS  = makeCharClass("()");
+    constexpr auto PATH_CHARS = makeCharClass("-()@:%_+.~#?&/=");
+
+    constexpr auto MAX_HOST_LENGTH = 256u;
+
+    constexpr auto DISCORD_CHANNELS = "discord.com/channels/"sv;
+
+    constexpr auto toLower(char c) noexcept -> core::UInt8 {
+        const auto byte = static_cast<core::UInt8>(c);
+
+        return (byte >= 'A' && byte <= 'Z') ? byte + ('a' - 'A') : byte;
+    }
+
+    constexpr auto startsWithNoCase(std::string_view text, std::string_view prefix) noexcept
+        -> bool {
+        if (std::size(text) < std::size(prefix)) return false;
+
+        return std::ranges::equal(text.substr(0, std::size(prefix)), prefix, {}, toLower, toLower);
+    }
+
+    auto parseSnowflake(std::string_view text, std::size_t &pos) noexcept
+        -> std::optional<dpp::snowflake> {
+        auto value = std::uint64_t { 0 };
+
+        const auto first     = std::data(text) + pos;
+        const auto [ptr, ec] = std::from_chars(first, std::data(text) + std::size(text), value);
+        if (ec != std::errc {}) return std::nullopt;
+
+        pos += static_cast<std::size_t>(ptr - first);
+
+        return dpp::snowflake { value };
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+MessageScanner::MessageScanner() noexcept = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+MessageScanner::~MessageScanner() = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+MessageScanner::MessageScanner(const MessageScanner &) = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::operator=(const MessageScanner &) -> MessageScanner & = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+MessageScanner::MessageScanner(MessageScanner &&) noexcept = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::operator=(MessageScanner &&) noexcept -> MessageScanner & = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::addKeyword(std::string_view keyword) -> KeywordID {
+    const auto id = m_next_keyword++;
+
+    auto literal = std::string {};
+    literal.reserve(std::size(keyword));
+    std::ranges::transform(keyword, std::back_inserter(literal), [](auto c) {
+        return static_cast<char>(toLower(c));
+    });
+
+    if (!std::empty(literal)) m_keywords.emplace_back(Literal { std::move(literal), id });
+
+    return id;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::enable(Features features) -> void {
+    m_features |= features;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::eraseKeywords(KeywordID first, KeywordID last) -> void {
+    std::erase_if(m_keywords, [first, last](const auto &literal) {
+        return literal.keyword >= first && literal.keyword < last;
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::disable(Features features) -> void {
+    m_features &= static_cast<core::UInt8>(~features);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::compile() -> void {
+    static constexpr auto NO_STATE = std::numeric_limits<State>::max();
+
+    auto literals = m_keywords;
+    if (m_features & (URLS | MESSAGE_LINKS)) {
+        literals.emplace_back(Literal { "http://", URL_SCHEME });
+        literals.emplace_back(Literal { "https://", URL_SCHEME });
+    }
+
+    auto transitions = std::vector<std::array<State, 256>> {};
+    auto outputs     = std::vector<std::vector<core::UInt32>> {};
+
+    const auto new_state = [&] {
+        transitions.emplace_back().fill(NO_STATE);
+        outputs.emplace_back();
+
+        return static_cast<State>(std::size(transitions) - 1);
+    };
+
+    new_state();
+
+    for (auto i = 0u; i < std::size(literals); ++i) {
+        auto state = State { 0 };
+
+        for (const auto c : literals[i].text) {
+            const auto byte = static_cast<core::UInt8>(c);
+            if (transitions[state][byte] == NO_STATE) {
+                const auto next          = new_state();
+                transitions[state][byte] = next;
+            }
+
+            state = transitions[state][byte];
+        }
+
+        outputs[state].emplace_back(i);
+    }
+
+    // breadth first traversal to resolve failure links, missing transitions are replaced by the
+    // ones of the failure state so the scan loop is a plain table lookup per byte
+    auto failures = std::vector<State>(std::size(transitions), 0);
+    auto queue    = std::deque<State> {};
+
+    for (auto &next : transitions[0]) {
+        if (next == NO_STATE) next = 0;
+        else
+            queue.emplace_back(next);
+    }
+
+    while (!std::empty(queue)) {
+        const auto state = queue.front();
+        queue.pop_front();
+
+        const auto failure = failures[state];
+        std::ranges::copy(outputs[failure], std::back_inserter(outputs[state]));
+
+        for (auto byte = 0u; byte < 256u; ++byte) {
+            auto &next = transitions[state][byte];
+
+            if (next == NO_STATE) next = transitions[failure][byte];
+            else {
+                failures[next] = transitions[failure][byte];
+                queue.emplace_back(next);
+            }
+        }
+    }
+
+    m_transitions = std::move(transitions);
+    m_outputs     = std::move(outputs);
+    m_literals    = std::move(literals);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::scan(std::string_view text) const -> Matches {
+    auto matches = Matches {};
+    scan(text, matches);
+
+    return matches;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::scan(std::string_view text, Matches &matches) const -> void {
+    if (std::empty(m_transitions)) return;
+
+    auto state   = State { 0 };
+    auto url_end = std::size_t { 0 };
+
+    for (auto i = 0u; i < std::size(text); ++i) {
+        state = m_transitions[state][toLower(text[i])];
+
+        for (const auto literal_id : m_outputs[state]) {
+            const auto &literal = m_literals[literal_id];
+            const auto begin    = i + 1 - std::size(literal.text);
+
+            if (literal.keyword != URL_SCHEME)
+                matches.keywords.emplace_back(
+                    Keyword { literal.keyword, text.substr(begin, std::size(literal.text)) });
+            else if (begin >= url_end)
+                url_end = matchUrl(text, begin, matches);
+        }
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageScanner::matchUrl(std::string_view text, std::size_t begin, Matches &matches) const
+    -> std::size_t {
+    const auto host_begin = begin + (toLower(text[begin + 4]) == 's' ? 8 : 7);
+
+    if (m_features & MESSAGE_LINKS && startsWithNoCase(text.substr(host_begin), DISCORD_CHANNELS)) {
+        auto pos = host_begin + std::size(DISCORD_CHANNELS);
+
+        auto guild_id = parseSnowflake(text, pos);
+        if (guild_id && pos < std::size(text) && text[pos++] == '/') {
+            auto channel_id = parseSnowflake(text, pos);
+
+            if (channel_id && pos < std::size(text) && text[pos++] == '/') {
+                auto message_id = parseSnowflake(text, pos);
+
+                if (message_id)
+                    matches.message_links.emplace_back(
+                        MessageLink { text.substr(begin, pos - begin),
+                                      *guild_id,
+                                      *channel_id,
+                                      *message_id });
+            }
+        }
+    }
+
+    if (!(m_features & URLS)) return host_begin;
+
+    auto host_end = host_begin;
+    while (host_end < std::size(text) && host_end - host_begin < MAX_HOST_LENGTH + 1 &&
+           HOST_CHARS[static_cast<core::UInt8>(text[host_end])])
+        ++host_end;
+
+    // needs at least one host character followed by ".<tld>"
+    auto has_tld = false;
+    for (auto pos = host_begin + 1; pos < host_end && !has_tld; ++pos)
+        has_tld = text[pos] == '.' && pos + 1 < std::size(text) &&
+                  TLD_CHARS[static_cast<core::UInt8>(text[pos + 1])];
+
+    if (!has_tld) return host_begin;
+
+    auto end = host_end;
+    while (end < std::size(text) && PATH_CHARS[static_cast<core::UInt8>(text[end])]) ++end;
+
+    matches.urls.emplace_back(text.substr(begin, end - begin));
+
+    return end;
+}
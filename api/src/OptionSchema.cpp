@@ -0,0 +1,181 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include <inquisitor/OptionSchema.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+    constexpr auto byValue = [](const dpp::snowflake &id) { return static_cast<std::uint64_t>(id); };
+
+    auto parseSnowflake(const json &value) -> dpp::snowflake {
+        if (value.is_number_unsigned()) return static_cast<dpp::snowflake>(value.get<std::uint64_t>());
+
+        if (!value.is_string()) throw std::invalid_argument { "expected a snowflake" };
+
+        const auto &string = value.get_ref<const std::string &>();
+
+        auto id          = std::uint64_t { 0 };
+        const auto *last = std::data(string) + std::size(string);
+        if (std::empty(string) || std::from_chars(std::data(string), last, id).ptr != last)
+            throw std::invalid_argument { std::format("\"{}\" isn't a snowflake", string) };
+
+        return static_cast<dpp::snowflake>(id);
+    }
+
+    auto parseDuration(const json &value) -> std::chrono::seconds {
+        if (value.is_number_unsigned()) return std::chrono::seconds { value.get<std::uint64_t>() };
+
+        if (!value.is_string()) throw std::invalid_argument { "expected a duration" };
+
+        const auto &string = value.get_ref<const std::string &>();
+
+        auto count       = std::uint64_t { 0 };
+        const auto *last = std::data(string) + std::size(string);
+        const auto [unit, error] = std::from_chars(std::data(string), last, count);
+        if (error != std::errc {} || unit == std::data(string))
+            throw std::invalid_argument { std::format("\"{}\" isn't a duration", string) };
+
+        const auto suffix = std::string_view { unit, last };
+        if (suffix == "s" || std::empty(suffix)) return std::chrono::seconds { count };
+        if (suffix == "min") return std::chrono::minutes { count };
+        if (suffix == "h") return std::chrono::hours { count };
+        if (suffix == "d") return std::chrono::days { count };
+
+        throw std::invalid_argument { std::format("unknown duration unit \"{}\"", suffix) };
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+SnowflakeSet::SnowflakeSet(std::vector<dpp::snowflake> ids) : m_ids { std::move(ids) } {
+    std::ranges::sort(m_ids, {}, byValue);
+
+    const auto duplicates = std::ranges::unique(m_ids, {}, byValue);
+    m_ids.erase(std::ranges::begin(duplicates), std::ranges::end(duplicates));
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto SnowflakeSet::contains(dpp::snowflake id) const noexcept -> bool {
+    return std::ranges::binary_search(m_ids, static_cast<std::uint64_t>(id), {}, byValue);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::snowflake(std::string name, dpp::snowflake &target, Presence presence)
+    -> OptionSchema & {
+    return add(std::move(name), presence, [&target](const json &value) -> Commit {
+        return [&target, id = parseSnowflake(value)] { target = id; };
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::snowflakes(std::string name, SnowflakeSet &target, Presence presence)
+    -> OptionSchema & {
+    return add(std::move(name), presence, [&target](const json &value) -> Commit {
+        if (!value.is_array()) throw std::invalid_argument { "expected an array of snowflakes" };
+
+        auto ids = std::vector<dpp::snowflake> {};
+        ids.reserve(std::size(value));
+        for (const auto &id : value) ids.emplace_back(parseSnowflake(id));
+
+        return [&target, set = SnowflakeSet { std::move(ids) }]() mutable {
+            target = std::move(set);
+        };
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::string(std::string name, std::string &target, Presence presence)
+    -> OptionSchema & {
+    return add(std::move(name), presence, [&target](const json &value) -> Commit {
+        if (!value.is_string()) throw std::invalid_argument { "expected a string" };
+
+        return [&target, string = value.get<std::string>()]() mutable {
+            target = std::move(string);
+        };
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::strings(std::string name, std::vector<std::string> &target, Presence presence)
+    -> OptionSchema & {
+    return add(std::move(name), presence, [&target](const json &value) -> Commit {
+        if (!value.is_array() || !std::ranges::all_of(value, &json::is_string))
+            throw std::invalid_argument { "expected an array of strings" };
+
+        return [&target, strings = value.get<std::vector<std::string>>()]() mutable {
+            target = std::move(strings);
+        };
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::duration(std::string name, std::chrono::seconds &target, Presence presence)
+    -> OptionSchema & {
+    return add(std::move(name), presence, [&target](const json &value) -> Commit {
+        return [&target, duration = parseDuration(value)] { target = duration; };
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::boolean(std::string name, bool &target, Presence presence) -> OptionSchema & {
+    return add(std::move(name), presence, [&target](const json &value) -> Commit {
+        if (!value.is_boolean()) throw std::invalid_argument { "expected a boolean" };
+
+        return [&target, boolean = value.get<bool>()] { target = boolean; };
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::validate(const json &options) const -> void {
+    [[maybe_unused]] const auto commits = parse(options);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::apply(const json &options) const -> void {
+    for (auto &commit : parse(options)) commit();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::add(std::string name, Presence presence, Parse parse) -> OptionSchema & {
+    m_options.emplace_back(Option { std::move(name), presence, std::move(parse) });
+
+    return *this;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto OptionSchema::parse(const json &options) const -> std::vector<Commit> {
+    auto commits = std::vector<Commit> {};
+    auto errors  = std::string {};
+
+    for (const auto &option : m_options) {
+        if (!options.is_object() || !options.contains(option.name)) {
+            if (option.presence == Presence::REQUIRED)
+                errors += std::format("\n  \"{}\" is missing", option.name);
+
+            continue;
+        }
+
+        try {
+            commits.emplace_back(option.parse(options[option.name]));
+        } catch (const std::exception &e) {
+            errors += std::format("\n  \"{}\": {}", option.name, e.what());
+        }
+    }
+
+    if (!std::empty(errors)) throw InvalidOptions { std::format("invalid options:{}", errors) };
+
+    return commits;
+}
@@ -4,6 +4,8 @@
 
 #include <inquisitor/PluginInterface.hpp>
 
+using namespace stormkit;
+
 /////////////////////////////////////
 /////////////////////////////////////
 PluginInterface::PluginInterface() noexcept = default;
@@ -14,7 +16,9 @@ PluginInterface::~PluginInterface() = default;
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto PluginInterface::initialize(const json &options, std::vector<const PluginInterface*> others) -> void {
+auto PluginInterface::initialize(const json &options,
+                                 std::vector<const PluginInterface *> others,
+                                 CoreServices &core) -> void {
     /*
     sendMessage = std::move(functions.send_message_func);
     sendFile = std::move(functions.send_file_func);
@@ -28,6 +32,35 @@ auto PluginInterface::initialize(const json &options, std::vector<const PluginIn
     getHttpFile = std::move(functions.get_http_file_func);*/
 
     m_others = std::move(others);
+    m_core   = &core;
 
+    applyOptions(options);
     initialize(options);
 }
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto PluginInterface::intents() const -> core::UInt32 {
+    if (!(subscription().events & Subscription::MESSAGE)) return dpp::i_guilds;
+
+    return dpp::i_guilds | dpp::i_guild_messages | dpp::i_direct_messages |
+           dpp::i_message_content;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto PluginInterface::validateOptions(const json &options) -> void {
+    auto schema = OptionSchema {};
+    describeOptions(schema);
+
+    schema.validate(options);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto PluginInterface::applyOptions(const json &options) -> void {
+    auto schema = OptionSchema {};
+    describeOptions(schema);
+
+    schema.apply(options);
+}
@@ -0,0 +1,106 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include <inquisitor/CodeBlock.hpp>
+
+static constexpr auto MESSAGE_COUNT = 10'000u;
+static constexpr auto ROUNDS        = 20u;
+
+static constexpr auto GLSL_REGEX =
+    R"(```glsl\n([a-zA-Z0-9\n\r\t^,:{}\[\]\-\.+=*$&\-\_%?\/" \(\);<>!]+)\n```)";
+
+static constexpr auto SHADER = R"(void main() {
+    vec2 uv = gl_FragCoord.xy / constants.resolution;
+    float t = constants.time * 0.5;
+
+    out_color = vec4(0.5 + 0.5 * cos(t + uv.xyx + vec3(0, 2, 4)), 1.0);
+})";
+
+// mostly chatter, some links and inline code, a few shaders and blocks in other languages
+static auto makeCorpus() -> std::vector<std::string> {
+    static constexpr auto CHATTER = std::array {
+        "hello everyone",
+        "did anyone try the new build? it crashes on startup for me",
+        "https://www.artstation.com/artwork/abc123 look at this",
+        "`vec3` is fine here, no need for a `vec4`",
+        "I'll post the shader tonight, still fighting with the uniforms :(",
+        "lol",
+        "```cpp\nauto main() -> int { return 0; }\n```",
+    };
+
+    auto generator = std::mt19937 { 42 };
+    auto corpus    = std::vector<std::string> {};
+    corpus.reserve(MESSAGE_COUNT);
+
+    for (auto i = 0u; i < MESSAGE_COUNT; ++i) {
+        if (i % 50 == 0) corpus.emplace_back(std::format("here you go\n```glsl\n{}\n```", SHADER));
+        else if (i % 97 == 0)
+            corpus.emplace_back(std::format("```GLSL\n{}\n```\nthanks!", SHADER));
+        else
+            corpus.emplace_back(CHATTER[generator() % std::size(CHATTER)]);
+    }
+
+    return corpus;
+}
+
+template<typename Func>
+static auto measure(std::span<const std::string> corpus, Func &&match)
+    -> std::pair<double, std::size_t> {
+    auto hits = std::size_t { 0 };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0u; i < ROUNDS; ++i)
+        for (const auto &message : corpus) hits += match(message);
+    const auto end = std::chrono::steady_clock::now();
+
+    return { std::chrono::duration<double, std::nano> { end - start }.count() /
+                 (ROUNDS * std::size(corpus)),
+             hits / ROUNDS };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto main() -> int {
+    const auto corpus = makeCorpus();
+
+    const auto regex = std::regex { GLSL_REGEX,
+                                    std::regex::ECMAScript | std::regex::optimize |
+                                        std::regex::icase };
+
+    for (const auto &message : corpus) {
+        auto matches    = std::smatch {};
+        const auto same = std::regex_search(message, matches, regex)
+                              ? CodeBlock<"glsl">::find(message) == matches[1].str()
+                              : !CodeBlock<"glsl">::find(message);
+
+        if (!same) {
+            std::cout << std::format("results differ on \"{}\"", message) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const auto [regex_ns, regex_hits] = measure(corpus, [&](const std::string &message) {
+        auto matches = std::smatch {};
+        if (!std::regex_search(message, matches, regex)) return false;
+
+        return matches[1].length() > 0;
+    });
+
+    const auto [block_ns, block_hits] = measure(corpus, [](const std::string &message) {
+        const auto body = CodeBlock<"glsl">::find(message);
+
+        return body && !body->empty();
+    });
+
+    std::cout << std::format("{} messages, {} shaders | std::regex {:>8.2f} ns | CodeBlock {:>6.2f} "
+                             "ns | x{:.1f}",
+                             std::size(corpus),
+                             block_hits,
+                             regex_ns,
+                             block_ns,
+                             regex_ns / block_ns)
+              << std::endl;
+
+    return (regex_hits == block_hits) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
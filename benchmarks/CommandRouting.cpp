@@ -0,0 +1,108 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "CommandRouter.hpp"
+
+static constexpr auto PLUGIN_COUNT   = 8u;
+static constexpr auto DISPATCH_COUNT = 1'000'000u;
+
+class BenchPlugin final: public PluginInterface {
+  public:
+    explicit BenchPlugin(std::string name) : m_name { std::move(name) } {}
+
+    [[nodiscard]] auto name() const -> const std::string & override { return m_name; }
+    [[nodiscard]] auto commands() const -> std::vector<Command> override {
+        auto commands = std::vector<Command> {};
+        commands.reserve(std::size(m_commands));
+
+        for (const auto &command : m_commands) commands.emplace_back(Command { command, "" });
+
+        return commands;
+    }
+
+    std::vector<std::string> m_commands;
+
+  private:
+    std::string m_name;
+};
+
+template<typename Func>
+static auto measure(std::span<const std::string> names, Func &&dispatch) -> double {
+    auto hits = std::size_t { 0 };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0u; i < DISPATCH_COUNT; ++i)
+        hits += dispatch(names[i % std::size(names)]) != nullptr;
+    const auto end = std::chrono::steady_clock::now();
+
+    if (hits != DISPATCH_COUNT)
+        std::cout << std::format("missed {} dispatches", DISPATCH_COUNT - hits) << std::endl;
+
+    return std::chrono::duration<double, std::nano> { end - start }.count() / DISPATCH_COUNT;
+}
+
+static auto benchmark(std::size_t command_count) -> void {
+    auto plugins = std::vector<std::unique_ptr<BenchPlugin>> {};
+    for (auto i = 0u; i < PLUGIN_COUNT; ++i)
+        plugins.emplace_back(std::make_unique<BenchPlugin>(std::format("Plugin{}", i)));
+
+    auto names  = std::vector<std::string> {};
+    auto ids    = std::vector<dpp::snowflake> {};
+    auto routes = std::vector<CommandRouter::Route> {};
+    for (auto i = 0u; i < command_count; ++i) {
+        auto &plugin = *plugins[i % PLUGIN_COUNT];
+        auto name    = std::format("command-{}", i);
+        auto id      = dpp::snowflake { 1'000'000'000'000'000'000ull + i };
+
+        plugin.m_commands.emplace_back(name);
+        routes.emplace_back(CommandRouter::Route { name, id, i % PLUGIN_COUNT });
+        names.emplace_back(std::move(name));
+        ids.emplace_back(id);
+    }
+
+    auto generator = std::mt19937 { 42 };
+    std::ranges::shuffle(names, generator);
+
+    // mirror of the previous on_interaction_create implementation
+    struct Commands {
+        PluginInterface *plugin;
+        std::vector<PluginInterface::Command> commands;
+    };
+
+    auto nested = std::vector<Commands> {};
+    for (auto &plugin : plugins) nested.emplace_back(Commands { plugin.get(), plugin->commands() });
+
+    const auto router = CommandRouter { std::move(routes) };
+
+    const auto nested_ns = measure(names, [&](std::string_view name) -> PluginInterface * {
+        for (auto &plugin : nested)
+            for (auto &command : plugin.commands)
+                if (name == command.name) return plugin.plugin;
+
+        return nullptr;
+    });
+
+    const auto by_name_ns = measure(names, [&](std::string_view name) { return router.find(name); });
+
+    auto i              = std::size_t { 0 };
+    const auto by_id_ns = measure(names, [&](std::string_view) {
+        return router.find(ids[i++ % std::size(ids)]);
+    });
+
+    std::cout << std::format("{:>5} commands | nested loop {:>9.2f} ns | router (name) {:>6.2f} ns "
+                             "| router (id) {:>6.2f} ns",
+                             command_count,
+                             nested_ns,
+                             by_name_ns,
+                             by_id_ns)
+              << std::endl;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto main() -> int {
+    for (const auto command_count : { 10u, 100u, 1000u }) benchmark(command_count);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,283 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Downloader.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// usage: download_benchmark [downloads] [bytes] [latency ms]
+// serves the downloads from a local HTTP/1.1 server which waits latency before every response,
+// standing in for the network round trip. GET /<bytes> answers with a Content-Length,
+// /chunked/<bytes> without one and /slow/<ms> after sleeping
+
+namespace {
+    constexpr auto ACCEPT_POLL_TIMEOUT = 100;
+
+    class LocalServer {
+      public:
+        explicit LocalServer(std::chrono::milliseconds latency) : m_latency { latency } {
+            m_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+            const auto reuse = 1;
+            setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            auto address            = sockaddr_in {};
+            address.sin_family      = AF_INET;
+            address.sin_port        = 0;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+            auto length = socklen_t { sizeof(address) };
+            if (bind(m_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 ||
+                listen(m_fd, 64) < 0 ||
+                getsockname(m_fd, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+                throw std::runtime_error { std::format("Failed to listen, reason: {}",
+                                                       std::strerror(errno)) };
+
+            m_port   = ntohs(address.sin_port);
+            m_thread = std::jthread { [this](std::stop_token token) { serve(std::move(token)); } };
+        }
+
+        ~LocalServer() {
+            m_thread.request_stop();
+            m_thread.join();
+
+            ::close(m_fd);
+        }
+
+        [[nodiscard]] auto url(std::string_view path) const -> std::string {
+            return std::format("http://127.0.0.1:{}/{}", m_port, path);
+        }
+
+        [[nodiscard]] auto connections() const noexcept -> std::size_t { return m_connections; }
+
+      private:
+        auto serve(std::stop_token token) -> void {
+            auto clients = std::vector<std::jthread> {};
+
+            while (!token.stop_requested()) {
+                auto poll_fd = pollfd { m_fd, POLLIN, 0 };
+                if (::poll(&poll_fd, 1, ACCEPT_POLL_TIMEOUT) <= 0) continue;
+
+                const auto client = accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client < 0) continue;
+
+                ++m_connections;
+                clients.emplace_back(
+                    [this, client](std::stop_token token) { talk(std::move(token), client); });
+            }
+        }
+
+        // keeps the connection open until the client closes it
+        auto talk(std::stop_token token, int client) -> void {
+            auto buffer = std::string {};
+
+            while (!token.stop_requested()) {
+                const auto end = buffer.find("\r\n\r\n");
+                if (end == std::string::npos) {
+                    auto poll_fd = pollfd { client, POLLIN, 0 };
+                    if (::poll(&poll_fd, 1, ACCEPT_POLL_TIMEOUT) <= 0) continue;
+
+                    auto chunk       = std::array<char, 4096> {};
+                    const auto count = recv(client, std::data(chunk), std::size(chunk), 0);
+                    if (count <= 0) break;
+
+                    buffer.append(std::data(chunk), static_cast<std::size_t>(count));
+                    continue;
+                }
+
+                // "GET /<path> HTTP/1.1"
+                const auto line = std::string_view { buffer }.substr(0, buffer.find(' ', 4));
+                respond(client, line.substr(std::min<std::size_t>(5, std::size(line))));
+
+                buffer.erase(0, end + 4);
+            }
+
+            ::close(client);
+        }
+
+        auto respond(int client, std::string_view path) const -> void {
+            std::this_thread::sleep_for(m_latency);
+
+            auto chunked = false;
+            if (path.starts_with("slow/")) {
+                std::this_thread::sleep_for(std::chrono::milliseconds { number(path.substr(5)) });
+                path = "0";
+            } else if (path.starts_with("chunked/")) {
+                chunked = true;
+                path    = path.substr(8);
+            }
+
+            const auto body = std::string(number(path), 'x');
+
+            auto response = std::string {};
+            if (chunked)
+                response = std::format("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                       "{:x}\r\n{}\r\n0\r\n\r\n",
+                                       std::size(body),
+                                       body);
+            else
+                response = std::format("HTTP/1.1 200 OK\r\nContent-Length: {}\r\n\r\n{}",
+                                       std::size(body),
+                                       body);
+
+            for (auto sent = std::size_t { 0 }; sent < std::size(response);) {
+                const auto count = send(client,
+                                        std::data(response) + sent,
+                                        std::size(response) - sent,
+                                        MSG_NOSIGNAL);
+                if (count <= 0) break;
+
+                sent += static_cast<std::size_t>(count);
+            }
+        }
+
+        static auto number(std::string_view text) -> std::size_t {
+            auto value = std::size_t { 0 };
+            std::from_chars(std::data(text), std::data(text) + std::size(text), value);
+
+            return value;
+        }
+
+        std::chrono::milliseconds m_latency;
+        int m_fd                               = -1;
+        stormkit::core::UInt16 m_port          = 0;
+        std::atomic<std::size_t> m_connections = 0;
+        std::jthread m_thread;
+    };
+
+    auto curlAppend(char *data, std::size_t size, std::size_t count, void *user_data)
+        -> std::size_t {
+        static_cast<std::string *>(user_data)->append(data, size * count);
+
+        return size * count;
+    }
+
+    // a fresh easy handle per download, the way getHttpFile used to work
+    auto downloadSequentially(const std::vector<std::string> &urls) -> std::size_t {
+        auto bytes = std::size_t { 0 };
+
+        for (const auto &url : urls) {
+            auto body = std::string {};
+
+            auto *curl = curl_easy_init();
+            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlAppend);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+            curl_easy_perform(curl);
+            curl_easy_cleanup(curl);
+
+            bytes += std::size(body);
+        }
+
+        return bytes;
+    }
+
+    auto downloadAtOnce(Downloader &downloader, const std::vector<std::string> &urls)
+        -> std::size_t {
+        auto futures = std::vector<std::future<Downloader::Result>> {};
+        futures.reserve(std::size(urls));
+
+        for (const auto &url : urls) futures.emplace_back(downloader.download({ .url = url }));
+
+        auto bytes = std::size_t { 0 };
+        for (auto &future : futures) {
+            const auto result = future.get();
+            if (!result.ok()) throw std::runtime_error { std::format("{}", result.error) };
+
+            bytes += std::size(result.body);
+        }
+
+        return bytes;
+    }
+
+    template<typename Func>
+    auto measure(std::string_view name, Func &&func) -> void {
+        const auto start = std::chrono::steady_clock::now();
+        const auto bytes = std::forward<Func>(func)();
+        const auto time  = std::chrono::duration<double, std::milli> {
+            std::chrono::steady_clock::now() - start
+        };
+
+        std::cout << std::format("{:<28} {:>10} bytes {:>10.1f}ms", name, bytes, time.count())
+                  << std::endl;
+    }
+
+    auto check(bool condition, std::string_view what) -> void {
+        std::cout << std::format("{:<28} {}", what, condition ? "ok" : "FAILED") << std::endl;
+        if (!condition) std::exit(EXIT_FAILURE);
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto main(int argc, char **argv) -> int {
+    const auto downloads = (argc > 1) ? std::stoul(argv[1]) : 64ul;
+    const auto bytes     = (argc > 2) ? std::stoul(argv[2]) : 256ul * 1024ul;
+    const auto latency   = std::chrono::milliseconds { (argc > 3) ? std::stol(argv[3]) : 5l };
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    {
+        auto server = LocalServer { latency };
+        auto urls   = std::vector<std::string>(downloads, server.url(std::to_string(bytes)));
+
+        measure("sequential easy handles", [&] { return downloadSequentially(urls); });
+        const auto sequential_connections = server.connections();
+
+        auto settings     = Settings::Downloads {};
+        settings.max_size = bytes * 4;
+        settings.timeout  = std::chrono::seconds { 5 };
+
+        auto downloader = Downloader { settings };
+
+        measure("downloader", [&] { return downloadAtOnce(downloader, urls); });
+        measure("downloader, warm", [&] { return downloadAtOnce(downloader, urls); });
+
+        const auto stats = downloader.stats();
+        std::cout << std::format("connections: {} sequential, {} downloader",
+                                 sequential_connections,
+                                 stats.connections)
+                  << std::endl;
+
+        check(stats.connections <= settings.parallel, "connections reused");
+
+        auto sized = downloader.download({ .url = server.url(std::to_string(bytes * 8)) }).get();
+        check(!sized.ok() && sized.status == 200, "Content-Length over limit");
+
+        auto chunked =
+            downloader.download({ .url = server.url(std::format("chunked/{}", bytes * 8)) }).get();
+        check(!chunked.ok() && chunked.size <= settings.max_size, "chunked over limit");
+
+        auto slow = downloader
+                        .download({ .url     = server.url("slow/2000"),
+                                    .timeout = std::chrono::milliseconds { 200 } })
+                        .get();
+        check(!slow.ok() && slow.status == 0, "timeout");
+
+        auto streamed_bytes = std::size_t { 0 };
+        auto streamed =
+            downloader
+                .download({ .url     = server.url(std::to_string(bytes)),
+                            .on_data = [&](std::string_view chunk) {
+                                streamed_bytes += std::size(chunk);
+                                return true;
+                            } })
+                .get();
+        check(streamed.ok() && std::empty(streamed.body) && streamed_bytes == bytes, "streamed");
+
+        auto aborted = downloader
+                           .download({ .url     = server.url(std::to_string(bytes)),
+                                       .on_data = [](std::string_view) { return false; } })
+                           .get();
+        check(!aborted.ok(), "aborted by the callback");
+    }
+
+    curl_global_cleanup();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,391 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "RequestScheduler.hpp"
+
+#include <curl/curl.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// usage: rate_limit_benchmark [requests per channel] [latency ms]
+// sends the requests through a RequestScheduler to a local REST server enforcing a rate limit
+// per route and channel the way Discord does. GET /limited/<channel> answers with the
+// x-ratelimit-* headers and a 429 once the budget of the channel is spent, /unknown/<channel>
+// without any rate limit header
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto ACCEPT_POLL_TIMEOUT = 100;
+
+    constexpr auto LIMIT    = 5;
+    constexpr auto WINDOW   = std::chrono::milliseconds { 250 };
+    constexpr auto CHANNELS = 4u;
+
+    constexpr auto MIN_OVERLAP = std::chrono::milliseconds { 5 };
+
+    constexpr auto CLIENT_THREADS = 16u;
+    constexpr auto QUEUED         = 20'000u;
+
+    class MockRest {
+      public:
+        explicit MockRest(std::chrono::milliseconds latency) : m_latency { latency } {
+            m_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+            const auto reuse = 1;
+            setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            auto address            = sockaddr_in {};
+            address.sin_family      = AF_INET;
+            address.sin_port        = 0;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+            auto length = socklen_t { sizeof(address) };
+            if (bind(m_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 ||
+                listen(m_fd, 64) < 0 ||
+                getsockname(m_fd, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+                throw std::runtime_error { std::format("Failed to listen, reason: {}",
+                                                       std::strerror(errno)) };
+
+            m_port   = ntohs(address.sin_port);
+            m_thread = std::jthread { [this](std::stop_token token) { serve(std::move(token)); } };
+        }
+
+        ~MockRest() {
+            m_thread.request_stop();
+            m_thread.join();
+
+            ::close(m_fd);
+        }
+
+        [[nodiscard]] auto url(std::string_view route, stormkit::core::UInt64 channel) const
+            -> std::string {
+            return std::format("http://127.0.0.1:{}/{}/{}", m_port, route, channel);
+        }
+
+        [[nodiscard]] auto limited() const noexcept -> std::size_t { return m_limited; }
+        [[nodiscard]] auto maxConcurrent() const noexcept -> std::size_t {
+            return m_max_concurrent;
+        }
+
+      private:
+        struct Window {
+            Clock::time_point start;
+            int used = 0;
+        };
+
+        auto serve(std::stop_token token) -> void {
+            auto clients = std::vector<std::jthread> {};
+
+            while (!token.stop_requested()) {
+                auto poll_fd = pollfd { m_fd, POLLIN, 0 };
+                if (::poll(&poll_fd, 1, ACCEPT_POLL_TIMEOUT) <= 0) continue;
+
+                const auto client = accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client < 0) continue;
+
+                clients.emplace_back(
+                    [this, client](std::stop_token token) { talk(std::move(token), client); });
+            }
+        }
+
+        // keeps the connection open until the client closes it
+        auto talk(std::stop_token token, int client) -> void {
+            auto buffer = std::string {};
+
+            while (!token.stop_requested()) {
+                const auto end = buffer.find("\r\n\r\n");
+                if (end == std::string::npos) {
+                    auto poll_fd = pollfd { client, POLLIN, 0 };
+                    if (::poll(&poll_fd, 1, ACCEPT_POLL_TIMEOUT) <= 0) continue;
+
+                    auto chunk       = std::array<char, 4096> {};
+                    const auto count = recv(client, std::data(chunk), std::size(chunk), 0);
+                    if (count <= 0) break;
+
+                    buffer.append(std::data(chunk), static_cast<std::size_t>(count));
+                    continue;
+                }
+
+                // "GET /<route>/<channel> HTTP/1.1"
+                const auto line = std::string_view { buffer }.substr(0, buffer.find(' ', 4));
+                const auto path = line.substr(std::min<std::size_t>(5, std::size(line)));
+
+                const auto slash = path.find('/');
+                respond(client, path.substr(0, slash), path.substr(slash + 1));
+
+                buffer.erase(0, end + 4);
+            }
+
+            ::close(client);
+        }
+
+        auto respond(int client, std::string_view route, std::string_view channel) -> void {
+            auto response = std::string { "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n" };
+
+            if (route == "limited") {
+                std::this_thread::sleep_for(m_latency);
+                response = limit(channel);
+            } else {
+                const auto concurrent = ++m_concurrent;
+                for (auto max = m_max_concurrent.load();
+                     concurrent > max && !m_max_concurrent.compare_exchange_weak(max, concurrent);)
+                    ;
+
+                // long enough for the requests to overlap
+                std::this_thread::sleep_for(std::max(m_latency, MIN_OVERLAP));
+
+                --m_concurrent;
+            }
+
+            for (auto sent = std::size_t { 0 }; sent < std::size(response);) {
+                const auto count = send(client,
+                                        std::data(response) + sent,
+                                        std::size(response) - sent,
+                                        MSG_NOSIGNAL);
+                if (count <= 0) break;
+
+                sent += static_cast<std::size_t>(count);
+            }
+        }
+
+        auto limit(std::string_view channel) -> std::string {
+            const auto now = Clock::now();
+
+            auto lock    = std::unique_lock { m_mutex };
+            auto &window = m_windows[std::string { channel }];
+            if (now - window.start >= WINDOW) window = Window { now, 0 };
+
+            const auto reset_after =
+                std::chrono::duration<double> { window.start + WINDOW - now }.count();
+
+            if (window.used >= LIMIT) {
+                ++m_limited;
+
+                return std::format("HTTP/1.1 429 Too Many Requests\r\nContent-Length: 0\r\n"
+                                   "x-ratelimit-bucket: limited\r\nx-ratelimit-remaining: 0\r\n"
+                                   "x-ratelimit-reset-after: {:.3f}\r\nretry-after: {:.3f}\r\n\r\n",
+                                   reset_after,
+                                   reset_after);
+            }
+
+            ++window.used;
+
+            return std::format("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n"
+                               "x-ratelimit-bucket: limited\r\nx-ratelimit-limit: {}\r\n"
+                               "x-ratelimit-remaining: {}\r\nx-ratelimit-reset-after: {:.3f}\r\n"
+                               "\r\n",
+                               LIMIT,
+                               LIMIT - window.used,
+                               reset_after);
+        }
+
+        std::chrono::milliseconds m_latency;
+        int m_fd                      = -1;
+        stormkit::core::UInt16 m_port = 0;
+        std::jthread m_thread;
+
+        std::mutex m_mutex;
+        stormkit::core::HashMap<std::string, Window> m_windows;
+
+        std::atomic<std::size_t> m_limited        = 0;
+        std::atomic<std::size_t> m_concurrent     = 0;
+        std::atomic<std::size_t> m_max_concurrent = 0;
+    };
+
+    // sends the requests issued by the scheduler from its own threads, the way dpp does
+    class HttpClient {
+      public:
+        HttpClient() {
+            for (auto i = 0u; i < CLIENT_THREADS; ++i)
+                m_workers.emplace_back([this](std::stop_token token) { work(std::move(token)); });
+        }
+
+        auto get(std::string url, RequestScheduler::Completion on_completion) -> void {
+            {
+                auto lock = std::unique_lock { m_mutex };
+                m_jobs.emplace_back(std::move(url), std::move(on_completion));
+            }
+
+            m_wake.notify_one();
+        }
+
+      private:
+        static auto onHeader(char *data, std::size_t size, std::size_t count, void *user_data)
+            -> std::size_t {
+            auto &http       = *static_cast<dpp::http_request_completion_t *>(user_data);
+            const auto line  = std::string_view { data, size * count };
+            const auto colon = line.find(':');
+
+            if (colon != std::string_view::npos) {
+                auto name = std::string { line.substr(0, colon) };
+                std::ranges::transform(name, std::begin(name), [](auto c) {
+                    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                });
+
+                auto value = line.substr(colon + 1);
+                while (!std::empty(value) && std::isspace(static_cast<unsigned char>(value[0])))
+                    value.remove_prefix(1);
+                while (!std::empty(value) && std::isspace(static_cast<unsigned char>(value.back())))
+                    value.remove_suffix(1);
+
+                http.headers.emplace(std::move(name), std::string { value });
+            }
+
+            return size * count;
+        }
+
+        static auto onData([[maybe_unused]] char *data,
+                           std::size_t size,
+                           std::size_t count,
+                           [[maybe_unused]] void *user_data) -> std::size_t {
+            return size * count;
+        }
+
+        auto work(std::stop_token token) -> void {
+            // keeps its connection alive across the requests
+            auto *curl = curl_easy_init();
+
+            while (!token.stop_requested()) {
+                auto lock = std::unique_lock { m_mutex };
+                if (!m_wake.wait(lock, token, [this] { return !std::empty(m_jobs); })) break;
+
+                auto [url, on_completion] = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                lock.unlock();
+
+                auto http = dpp::http_request_completion_t {};
+
+                curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+                curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, onHeader);
+                curl_easy_setopt(curl, CURLOPT_HEADERDATA, &http);
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, onData);
+                curl_easy_perform(curl);
+
+                auto status = 0L;
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+                http.status = static_cast<stormkit::core::UInt16>(status);
+
+                on_completion(dpp::confirmation_callback_t { nullptr, dpp::confirmation {}, http });
+            }
+
+            curl_easy_cleanup(curl);
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_wake;
+        std::deque<std::pair<std::string, RequestScheduler::Completion>> m_jobs;
+
+        std::vector<std::jthread> m_workers;
+    };
+
+    // submits count requests per channel and waits for all of them
+    auto run(RequestScheduler &scheduler,
+             HttpClient &client,
+             const MockRest &server,
+             std::string_view route,
+             std::size_t count,
+             std::size_t channels) -> std::size_t {
+        auto done = std::latch { static_cast<std::ptrdiff_t>(count * channels) };
+
+        for (auto i = 0u; i < count; ++i)
+            for (auto channel = stormkit::core::UInt64 { 1 }; channel <= channels; ++channel)
+                scheduler.submit(
+                    std::string { route },
+                    channel,
+                    RequestScheduler::Priority::REPLY,
+                    [&client, url = server.url(route, channel)](auto callback) mutable {
+                        client.get(std::move(url), std::move(callback));
+                    },
+                    [&done](const auto &) { done.count_down(); });
+
+        done.wait();
+
+        return count * channels;
+    }
+
+    template<typename Func>
+    auto measure(std::string_view name, Func &&func) -> std::chrono::duration<double> {
+        const auto start    = Clock::now();
+        const auto requests = std::forward<Func>(func)();
+        const auto time     = std::chrono::duration<double> { Clock::now() - start };
+
+        std::cout << std::format("{:<32} {:>8} requests {:>10.1f}ms",
+                                 name,
+                                 requests,
+                                 time.count() * 1000.)
+                  << std::endl;
+
+        return time;
+    }
+
+    auto check(bool condition, std::string_view what) -> void {
+        std::cout << std::format("{:<32} {}", what, condition ? "ok" : "FAILED") << std::endl;
+        if (!condition) std::exit(EXIT_FAILURE);
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto main(int argc, char **argv) -> int {
+    const auto count   = (argc > 1) ? std::stoul(argv[1]) : 20ul;
+    const auto latency = std::chrono::milliseconds { (argc > 2) ? std::stol(argv[2]) : 5l };
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    {
+        auto server    = MockRest { latency };
+        auto client    = HttpClient {};
+        auto scheduler = RequestScheduler {};
+
+        // a bucket shared by every channel would take this long
+        const auto windows = (count * CHANNELS + LIMIT - 1) / LIMIT;
+        const auto shared  = std::chrono::duration<double> { WINDOW * (windows - 1) };
+
+        const auto limited = measure("limited route, per channel", [&] {
+            return run(scheduler, client, server, "limited", count, CHANNELS);
+        });
+
+        check(server.limited() == 0, "no 429");
+        check(limited < shared, "channels in parallel");
+
+        measure("unknown route", [&] {
+            return run(scheduler, client, server, "unknown", count, 1);
+        });
+
+        check(server.maxConcurrent() > 1 &&
+                  server.maxConcurrent() <= RequestScheduler::UNKNOWN_IN_FLIGHT,
+              "unknown route concurrent");
+
+        // requests complete right away, only the dispatch itself is measured
+        measure("dispatch", [&] {
+            auto done = std::latch { QUEUED };
+
+            for (auto i = 0u; i < QUEUED; ++i)
+                scheduler.submit(
+                    "local",
+                    i % CHANNELS,
+                    RequestScheduler::Priority::HOUSEKEEPING,
+                    [](auto callback) {
+                        const auto http = dpp::http_request_completion_t {};
+                        callback(dpp::confirmation_callback_t { nullptr, dpp::confirmation {}, http });
+                    },
+                    [&done](const auto &) { done.count_down(); });
+
+            done.wait();
+
+            return std::size_t { QUEUED };
+        });
+
+        check(scheduler.pending() == 0, "nothing pending");
+    }
+
+    curl_global_cleanup();
+
+    return EXIT_SUCCESS;
+}
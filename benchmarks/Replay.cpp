@@ -0,0 +1,135 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Inquisitor.hpp"
+#include "Settings.hpp"
+#include "Supervisor.hpp"
+
+// usage: inquisitor_replay <event log>
+// run from a directory holding the settings.json and plugins/ to benchmark, record the log with
+// the "record_events" setting. With more than one sharding.clusters, the log stands in for the
+// gateway of a supervised multi-process run, each cluster replays the events of its own shards
+
+namespace {
+    struct AllocationCounter {
+        std::atomic<const Executor *> owner = nullptr;
+        std::atomic<std::size_t> count      = 0;
+        std::atomic<std::size_t> bytes      = 0;
+    };
+
+    constexpr auto MAX_COUNTERS = 64u;
+
+    // one counter per executor, the last one gathers the allocations made outside of them
+    std::array<AllocationCounter, MAX_COUNTERS + 1> g_counters;
+
+    auto counterOf(const Executor *executor) noexcept -> AllocationCounter & {
+        if (!executor) return g_counters.back();
+
+        for (auto i = 0u; i < MAX_COUNTERS; ++i) {
+            auto &counter = g_counters[i];
+
+            auto owner = counter.owner.load(std::memory_order_relaxed);
+            if (owner == executor) return counter;
+            if (owner) continue;
+
+            if (counter.owner.compare_exchange_strong(owner, executor) || owner == executor)
+                return counter;
+        }
+
+        return g_counters.back();
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto operator new(std::size_t size) -> void * {
+    auto &counter = counterOf(Executor::current());
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (auto *ptr = std::malloc(std::max<std::size_t>(size, 1)); ptr) return ptr;
+
+    throw std::bad_alloc {};
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto operator delete(void *ptr) noexcept -> void {
+    std::free(ptr);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto operator delete(void *ptr, [[maybe_unused]] std::size_t size) noexcept -> void {
+    std::free(ptr);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+static auto replayCluster(stormkit::core::UInt32 cluster_id, const char *path) -> int {
+    auto inquisitor = Inquisitor { cluster_id, Inquisitor::Mode::REPLAY };
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto count = inquisitor.replay(path);
+    inquisitor.waitIdle();
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double> { end - start }.count();
+
+    std::cout << std::format("cluster {}: {} events in {:.3f}s, {:.0f} events/s",
+                             cluster_id,
+                             count,
+                             seconds,
+                             static_cast<double>(count) / seconds)
+              << std::endl;
+
+    for (const auto *executor : inquisitor.executors()) {
+        const auto stats    = executor->stats();
+        const auto &counter = counterOf(executor);
+
+        std::cout << std::format("{:<24} | {:>8} tasks | busy {:>10.3f} ms | {:>9} allocations "
+                                 "({} bytes)",
+                                 executor->name(),
+                                 stats.executed,
+                                 static_cast<double>(stats.busy.count()) / 1000.,
+                                 counter.count.load(),
+                                 counter.bytes.load())
+                  << std::endl;
+    }
+
+    std::cout << std::format("{:<24} | {:>9} allocations ({} bytes)",
+                             "core",
+                             g_counters.back().count.load(),
+                             g_counters.back().bytes.load())
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto main(const int argc, const char **argv) -> int {
+    if (argc < 2) {
+        std::cerr << std::format("usage: {} <event log>", argv[0]) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto clusters = Settings::load().sharding.clusters;
+    if (clusters == 1) return replayCluster(0, argv[1]);
+
+    auto supervisor = Supervisor { clusters, [argv](auto cluster_id) {
+                                      return replayCluster(cluster_id, argv[1]);
+                                  } };
+
+    const auto start  = std::chrono::steady_clock::now();
+    const auto result = supervisor.run();
+    const auto end    = std::chrono::steady_clock::now();
+
+    std::cout << std::format("{} clusters in {:.3f}s",
+                             clusters,
+                             std::chrono::duration<double> { end - start }.count())
+              << std::endl;
+
+    return result;
+}
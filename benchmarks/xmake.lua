@@ -0,0 +1,53 @@
+target("command_routing_benchmark")
+    set_kind("binary")
+    set_languages("cxxlatest", "clatest")
+    set_default(false)
+
+    add_files("CommandRouting.cpp", "../inquisitor/src/CommandRouter.cpp")
+    add_includedirs("../inquisitor/src")
+
+    add_deps("inquisitor_api")
+
+target("inquisitor_replay")
+    set_kind("binary")
+    set_languages("cxxlatest", "clatest")
+    set_default(false)
+
+    set_pcxxheader("../inquisitor/src/CoreDependencies.hpp")
+    add_files("Replay.cpp", "../inquisitor/src/*.cpp")
+    remove_files("../inquisitor/src/main.cpp")
+    add_includedirs("../inquisitor/src")
+
+    add_deps("inquisitor_api")
+    add_packages("libcurl")
+
+target("code_block_benchmark")
+    set_kind("binary")
+    set_languages("cxxlatest", "clatest")
+    set_default(false)
+
+    add_files("CodeBlock.cpp")
+
+    add_deps("inquisitor_api")
+
+target("download_benchmark")
+    set_kind("binary")
+    set_languages("cxxlatest", "clatest")
+    set_default(false)
+
+    add_files("Download.cpp", "../inquisitor/src/Downloader.cpp")
+    add_includedirs("../inquisitor/src")
+
+    add_deps("inquisitor_api")
+    add_packages("libcurl")
+
+target("rate_limit_benchmark")
+    set_kind("binary")
+    set_languages("cxxlatest", "clatest")
+    set_default(false)
+
+    add_files("RateLimit.cpp", "../inquisitor/src/RequestScheduler.cpp")
+    add_includedirs("../inquisitor/src")
+
+    add_deps("inquisitor_api")
+    add_packages("libcurl")
@@ -0,0 +1,154 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Arena.hpp"
+
+namespace {
+    auto nextOf(void *block) noexcept -> void *& {
+        return *static_cast<void **>(block);
+    }
+
+    auto freeAll(void *block) noexcept -> void {
+        while (block) ::operator delete(std::exchange(block, nextOf(block)));
+    }
+
+    struct Pool {
+        ~Pool() {
+            freeAll(head);
+            freeAll(returned.load(std::memory_order_acquire));
+        }
+
+        // a BLOCK_SIZE block, the pool stays alive until it comes back
+        auto take() -> void * {
+            // blocks released by other threads are reclaimed all at once
+            if (!head) {
+                auto *block = returned.exchange(nullptr, std::memory_order_acquire);
+                while (block) keep(std::exchange(block, nextOf(block)));
+            }
+
+            refs.fetch_add(1, std::memory_order_relaxed);
+
+            if (!head) return ::operator new(Arena::BLOCK_SIZE);
+
+            --count;
+            return std::exchange(head, nextOf(head));
+        }
+
+        // from the owning thread
+        auto release(void *block) noexcept -> void {
+            keep(block);
+            unref();
+        }
+
+        // from any other thread
+        auto giveBack(void *block) noexcept -> void {
+            auto *first = returned.load(std::memory_order_relaxed);
+            do {
+                nextOf(block) = first;
+            } while (!returned.compare_exchange_weak(first,
+                                                     block,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed));
+
+            unref();
+        }
+
+        auto unref() noexcept -> void {
+            if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+        }
+
+        // only touched by the owning thread
+        void *head        = nullptr;
+        std::size_t count = 0;
+
+        std::atomic<void *> returned = nullptr;
+        // the owning thread and the blocks it handed out
+        std::atomic_size_t refs = 1;
+
+      private:
+        auto keep(void *block) noexcept -> void {
+            if (count >= Arena::POOL_SIZE) {
+                ::operator delete(block);
+                return;
+            }
+
+            nextOf(block) = std::exchange(head, block);
+            ++count;
+        }
+    };
+
+    // the blocks still in use when the thread exits keep its pool alive
+    struct ThreadPool {
+        ~ThreadPool() {
+            freeAll(std::exchange(pool->head, nullptr));
+            pool->unref();
+        }
+
+        Pool *pool = new Pool {};
+    };
+
+    thread_local auto t_pool = ThreadPool {};
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+Arena::Arena() noexcept = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+Arena::~Arena() {
+    release();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Arena::release() noexcept -> void {
+    while (m_blocks) {
+        auto *block = std::exchange(m_blocks, m_blocks->next);
+        auto *pool  = static_cast<Pool *>(block->pool);
+
+        if (!pool)
+            ::operator delete(block);
+        else if (pool == t_pool.pool)
+            pool->release(block);
+        else
+            pool->giveBack(block);
+    }
+
+    m_current   = nullptr;
+    m_remaining = 0;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Arena::do_allocate(std::size_t bytes, std::size_t alignment) -> void * {
+    auto *current = static_cast<void *>(m_current);
+    if (current && std::align(alignment, bytes, current, m_remaining)) {
+        m_current = static_cast<std::byte *>(current) + bytes;
+        m_remaining -= bytes;
+
+        return current;
+    }
+
+    // oversized requests get a block of their own
+    const auto needed = sizeof(Block) + bytes + alignment;
+    const auto size   = std::max(needed, BLOCK_SIZE);
+
+    auto *pool   = (size == BLOCK_SIZE) ? t_pool.pool : nullptr;
+    auto *memory = pool ? pool->take() : ::operator new(size);
+
+    auto *block = ::new (memory) Block { m_blocks, size, pool };
+    m_blocks    = block;
+
+    m_current   = reinterpret_cast<std::byte *>(block + 1);
+    m_remaining = size - sizeof(Block);
+
+    current = static_cast<void *>(m_current);
+    std::align(alignment, bytes, current, m_remaining);
+
+    m_current = static_cast<std::byte *>(current) + bytes;
+    m_remaining -= bytes;
+
+    return current;
+}
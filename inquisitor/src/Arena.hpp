@@ -0,0 +1,46 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Monotonic scratch memory of one dispatched event, everything is freed at once when the arena
+// dies. Blocks come from a pool owned by the calling thread and go back to that pool whichever
+// thread releases them, so a busy thread reuses warm blocks without touching malloc even when
+// its events end on other threads. Not thread safe
+class Arena final: public std::pmr::memory_resource {
+  public:
+    static constexpr auto BLOCK_SIZE = std::size_t { 16 * 1024 };
+    // blocks kept for reuse by every thread
+    static constexpr auto POOL_SIZE = std::size_t { 16 };
+
+    Arena() noexcept;
+    ~Arena() override;
+
+    Arena(const Arena &)                    = delete;
+    auto operator=(const Arena &) -> Arena & = delete;
+
+    auto release() noexcept -> void;
+
+  private:
+    struct Block {
+        Block *next;
+        std::size_t size;
+        // the pool of the thread which allocated it, nullptr for oversized blocks
+        void *pool;
+    };
+
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override;
+    auto do_deallocate(void *, std::size_t, std::size_t) -> void override {}
+    [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource &other) const noexcept
+        -> bool override {
+        return this == &other;
+    }
+
+    Block *m_blocks = nullptr;
+
+    std::byte *m_current   = nullptr;
+    std::size_t m_remaining = 0;
+};
@@ -0,0 +1,111 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "CacheBudget.hpp"
+
+namespace {
+    // hash map node, next pointer and cached hash
+    constexpr auto NODE_OVERHEAD = 2 * sizeof(void *);
+
+    template<typename T>
+    constexpr auto ENTRY_BYTES = sizeof(T) + sizeof(dpp::snowflake) + NODE_OVERHEAD;
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+CacheBudget::CacheBudget(std::size_t budget) : m_budget { budget } {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CacheBudget::report() const -> Report {
+    auto report = Report { .guilds = {}, .users = 0, .user_bytes = 0, .bytes = 0 };
+
+    {
+        auto lock = std::unique_lock { m_mutex };
+
+        report.guilds.reserve(std::size(m_guilds));
+        for (const auto &[_, usage] : m_guilds) {
+            report.bytes += usage.bytes;
+            report.guilds.emplace_back(usage);
+        }
+    }
+
+    report.users      = dpp::get_user_cache()->count();
+    report.user_bytes = report.users * ENTRY_BYTES<dpp::user>;
+    report.bytes += report.user_bytes;
+
+    std::ranges::sort(report.guilds, std::ranges::greater {}, &GuildUsage::bytes);
+
+    return report;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CacheBudget::plan(const Report &report) -> std::size_t {
+    if (m_budget == 0 || report.bytes <= m_budget) return 0;
+
+    auto planned = std::vector<std::uint64_t> {};
+
+    // members are the only part which grows with the guild activity and can be fetched again
+    auto excess = report.bytes - m_budget;
+    for (const auto &guild : report.guilds) {
+        if (excess == 0) break;
+        if (guild.members == 0) continue;
+
+        const auto freed = guild.members * ENTRY_BYTES<dpp::guild_member>;
+        excess -= std::min(excess, freed);
+
+        planned.emplace_back(static_cast<std::uint64_t>(guild.id));
+    }
+
+    std::ranges::sort(planned);
+
+    const auto count = std::size(planned);
+
+    auto lock = std::unique_lock { m_mutex };
+    m_planned = std::move(planned);
+
+    return count;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CacheBudget::sample(dpp::snowflake guild_id) -> void {
+    auto *guild = dpp::find_guild(guild_id);
+    if (!guild) return;
+
+    const auto id = static_cast<std::uint64_t>(guild_id);
+
+    auto lock = std::unique_lock { m_mutex };
+
+    if (const auto it = std::ranges::lower_bound(m_planned, id);
+        it != std::ranges::end(m_planned) && *it == id) {
+        m_planned.erase(it);
+
+        m_trimmed_members += std::size(guild->members);
+        guild->members.clear();
+    }
+
+    auto usage = GuildUsage { .id       = guild_id,
+                              .members  = std::size(guild->members),
+                              .channels = std::size(guild->channels),
+                              .roles    = std::size(guild->roles),
+                              .emojis   = std::size(guild->emojis),
+                              .bytes    = 0 };
+
+    usage.bytes = ENTRY_BYTES<dpp::guild> + usage.members * ENTRY_BYTES<dpp::guild_member> +
+                  usage.channels * ENTRY_BYTES<dpp::channel> +
+                  usage.roles * ENTRY_BYTES<dpp::role> + usage.emojis * ENTRY_BYTES<dpp::emoji>;
+
+    m_guilds.insert_or_assign(id, usage);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CacheBudget::forget(dpp::snowflake guild_id) -> void {
+    auto lock = std::unique_lock { m_mutex };
+
+    m_guilds.erase(static_cast<std::uint64_t>(guild_id));
+}
@@ -0,0 +1,56 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Approximate size of the dpp caches per guild, and the optional budget which drops the cached
+// members of the largest guilds when exceeded. dpp mutates a guild from its shard thread without
+// locking it, so the guilds are only read and trimmed by sample() on that thread, the report is
+// made of the last samples
+class CacheBudget {
+  public:
+    struct GuildUsage {
+        dpp::snowflake id;
+        std::size_t members;
+        std::size_t channels;
+        std::size_t roles;
+        std::size_t emojis;
+        std::size_t bytes;
+    };
+
+    struct Report {
+        // sorted by decreasing bytes
+        std::vector<GuildUsage> guilds;
+        std::size_t users;
+        std::size_t user_bytes;
+        // guilds and users
+        std::size_t bytes;
+    };
+
+    // a budget of 0 never trims
+    explicit CacheBudget(std::size_t budget);
+
+    [[nodiscard]] auto report() const -> Report;
+
+    // returns the number of guilds which will be trimmed
+    auto plan(const Report &report) -> std::size_t;
+    // must be called from the shard thread of the guild, trims it if it was planned and records
+    // its size
+    auto sample(dpp::snowflake guild_id) -> void;
+    auto forget(dpp::snowflake guild_id) -> void;
+
+    [[nodiscard]] auto budget() const noexcept -> std::size_t { return m_budget; }
+    [[nodiscard]] auto trimmedMembers() const noexcept -> std::size_t { return m_trimmed_members; }
+
+  private:
+    std::size_t m_budget;
+
+    mutable std::mutex m_mutex;
+    stormkit::core::HashMap<std::uint64_t, GuildUsage> m_guilds;
+    std::vector<std::uint64_t> m_planned;
+
+    std::atomic_size_t m_trimmed_members = 0;
+};
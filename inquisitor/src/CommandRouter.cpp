@@ -0,0 +1,65 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "CommandRouter.hpp"
+
+/////////////////////////////////////
+/////////////////////////////////////
+CommandRouter::CommandRouter() noexcept = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+CommandRouter::CommandRouter(std::vector<Route> routes) : m_routes { std::move(routes) } {
+    m_by_name.reserve(std::size(m_routes));
+    m_by_id.reserve(std::size(m_routes));
+
+    // keys are views on m_routes, which is never modified after this point
+    for (const auto &route : m_routes) {
+        m_by_name.emplace(std::string_view { route.name }, &route);
+
+        if (!route.id.empty()) m_by_id.emplace(static_cast<std::uint64_t>(route.id), &route);
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+CommandRouter::~CommandRouter() = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+CommandRouter::CommandRouter(CommandRouter &&) noexcept = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandRouter::operator=(CommandRouter &&) noexcept -> CommandRouter & = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandRouter::find(std::string_view name) const noexcept -> const Route * {
+    const auto it = m_by_name.find(name);
+    if (it == std::ranges::cend(m_by_name)) return nullptr;
+
+    return it->second;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandRouter::find(dpp::snowflake id) const noexcept -> const Route * {
+    const auto it = m_by_id.find(static_cast<std::uint64_t>(id));
+    if (it == std::ranges::cend(m_by_id)) return nullptr;
+
+    return it->second;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandRouter::route(const dpp::interaction_create_t &event) const noexcept
+    -> const Route * {
+    const auto *command = std::get_if<dpp::command_interaction>(&event.command.data);
+    if (!command) return nullptr;
+
+    if (const auto *route = find(command->id); route) return route;
+
+    return find(std::string_view { command->name });
+}
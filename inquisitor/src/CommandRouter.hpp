@@ -0,0 +1,53 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+#include <ankerl/unordered_dense.h>
+
+class CommandRouter {
+  public:
+    struct Route {
+        std::string name;
+        dpp::snowflake id;
+        // index of the plugin slot, stable across plugin reloads
+        std::size_t plugin;
+    };
+
+    CommandRouter() noexcept;
+    explicit CommandRouter(std::vector<Route> routes);
+    ~CommandRouter();
+
+    CommandRouter(const CommandRouter &)                    = delete;
+    auto operator=(const CommandRouter &) -> CommandRouter & = delete;
+
+    CommandRouter(CommandRouter &&) noexcept;
+    auto operator=(CommandRouter &&) noexcept -> CommandRouter &;
+
+    [[nodiscard]] auto find(std::string_view name) const noexcept -> const Route *;
+    [[nodiscard]] auto find(dpp::snowflake id) const noexcept -> const Route *;
+
+    [[nodiscard]] auto route(const dpp::interaction_create_t &event) const noexcept
+        -> const Route *;
+
+    [[nodiscard]] auto routes() const noexcept -> std::span<const Route> { return m_routes; }
+
+  private:
+    struct StringHash {
+        using is_transparent = void;
+        using is_avalanching = void;
+
+        [[nodiscard]] auto operator()(std::string_view str) const noexcept -> std::uint64_t {
+            return ankerl::unordered_dense::hash<std::string_view> {}(str);
+        }
+    };
+
+    std::vector<Route> m_routes;
+
+    ankerl::unordered_dense::map<std::string_view, const Route *, StringHash, std::equal_to<>>
+        m_by_name;
+    ankerl::unordered_dense::map<std::uint64_t, const Route *> m_by_id;
+};
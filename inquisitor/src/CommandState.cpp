@@ -0,0 +1,110 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "CommandState.hpp"
+
+using json = nlohmann::json;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandState::load(const std::filesystem::path &path) -> std::optional<CommandState> {
+    auto file = std::ifstream { path };
+    if (!file) return std::nullopt;
+
+    try {
+        const auto document = json::parse(file);
+
+        auto state           = CommandState {};
+        state.application_id = std::stoull(document.at("application_id").get<std::string>());
+        state.fingerprint    = document.at("fingerprint").get<std::string>();
+
+        for (const auto &[name, id] : document.at("commands").items())
+            state.ids.emplace(name, std::stoull(id.get<std::string>()));
+
+        return state;
+    } catch (const std::exception &e) {
+        wlog("Ignoring invalid {}, reason: {}", path.string(), e.what());
+    }
+
+    return std::nullopt;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandState::save(const std::filesystem::path &path) const -> void {
+    auto document              = json {};
+    document["application_id"] = std::to_string(application_id);
+    document["fingerprint"]    = fingerprint;
+    document["commands"]       = json::object();
+
+    for (const auto &[name, id] : ids) document["commands"][name] = std::to_string(id);
+
+    // write then rename so a crash never leaves a truncated file behind
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        auto file = std::ofstream { tmp_path, std::ios::trunc };
+        if (!file) {
+            elog("Failed to write {}", tmp_path.string());
+            return;
+        }
+
+        file << document.dump(4);
+    }
+
+    auto error = std::error_code {};
+    std::filesystem::rename(tmp_path, path, error);
+    if (error) elog("Failed to write {}, reason: {}", path.string(), error.message());
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandState::fingerprintOf(std::span<const dpp::slashcommand> commands) -> std::string {
+    auto sorted = std::vector<const dpp::slashcommand *> {};
+    sorted.reserve(std::size(commands));
+    for (const auto &command : commands) sorted.emplace_back(&command);
+
+    std::ranges::sort(sorted, {}, &dpp::slashcommand::name);
+
+    // FNV-1a over the registration payload of every command, options, choices and permissions
+    // included. The fields discord assigns are left out
+    static constexpr auto FNV_OFFSET = std::uint64_t { 14695981039346656037ull };
+    static constexpr auto FNV_PRIME  = std::uint64_t { 1099511628211ull };
+
+    auto hash       = FNV_OFFSET;
+    const auto feed = [&hash](std::string_view data) {
+        for (const auto c : data) {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= FNV_PRIME;
+        }
+
+        hash ^= 0xff;
+        hash *= FNV_PRIME;
+    };
+
+    for (const auto *command : sorted) {
+        auto document = json::parse(command->build_json(false));
+        for (const auto volatile_field : { "id", "version", "application_id" })
+            document.erase(volatile_field);
+
+        // object keys are sorted, the dump doesn't depend on the registration order of the fields
+        feed(document.dump());
+    }
+
+    return std::format("{:016x}", hash);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto CommandState::fromCommands(dpp::snowflake application_id,
+                                std::span<const dpp::slashcommand> commands) -> CommandState {
+    auto state           = CommandState {};
+    state.application_id = application_id;
+    state.fingerprint    = fingerprintOf(commands);
+
+    for (const auto &command : commands) state.ids.emplace(command.name, command.id);
+
+    return state;
+}
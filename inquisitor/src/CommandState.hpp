@@ -0,0 +1,27 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Last slash command set registered to discord, persisted so an unchanged restart doesn't need
+// any registration call
+struct CommandState {
+    static constexpr auto PATH = "registered_commands.json";
+
+    dpp::snowflake application_id;
+    std::string fingerprint;
+    stormkit::core::HashMap<std::string, dpp::snowflake> ids;
+
+    [[nodiscard]] static auto load(const std::filesystem::path &path = PATH)
+        -> std::optional<CommandState>;
+    auto save(const std::filesystem::path &path = PATH) const -> void;
+
+    [[nodiscard]] static auto fingerprintOf(std::span<const dpp::slashcommand> commands)
+        -> std::string;
+    [[nodiscard]] static auto fromCommands(dpp::snowflake application_id,
+                                           std::span<const dpp::slashcommand> commands)
+        -> CommandState;
+};
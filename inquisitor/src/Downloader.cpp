@@ -0,0 +1,227 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Downloader.hpp"
+
+using namespace stormkit;
+
+namespace {
+    constexpr auto POLL_TIMEOUT  = 1000;
+    constexpr auto MAX_REDIRECTS = 5L;
+
+    // 0 means the limit
+    template<typename T>
+    auto lowered(T requested, T limit) -> T {
+        return (requested == T {} || requested > limit) ? limit : requested;
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+Downloader::Downloader(Settings::Downloads settings)
+    : m_settings { std::move(settings) }, m_multi { curl_multi_init() } {
+    const auto parallel         = static_cast<long>(m_settings.parallel);
+    const auto host_connections = static_cast<long>(m_settings.host_connections);
+
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, parallel);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, host_connections);
+    curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, parallel);
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+    m_thread = std::jthread { [this](std::stop_token token) { work(std::move(token)); } };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Downloader::~Downloader() {
+    m_thread.request_stop();
+    curl_multi_wakeup(m_multi);
+    m_thread.join();
+
+    for (auto &transfer : m_transfers) {
+        curl_multi_remove_handle(m_multi, transfer->handle);
+        curl_easy_cleanup(transfer->handle);
+
+        transfer->result.error = "downloader stopped";
+        transfer->promise.set_value(std::move(transfer->result));
+    }
+
+    for (auto &transfer : m_queue) {
+        transfer->result.error = "downloader stopped";
+        transfer->promise.set_value(std::move(transfer->result));
+    }
+
+    for (auto *handle : m_idle_handles) curl_easy_cleanup(handle);
+
+    curl_multi_cleanup(m_multi);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Downloader::download(Request request) -> std::future<Result> {
+    auto transfer      = std::make_unique<Transfer>();
+    transfer->max_size = lowered(request.max_size, m_settings.max_size);
+    transfer->timeout  = lowered(request.timeout, m_settings.timeout);
+    transfer->request  = std::move(request);
+
+    auto future = transfer->promise.get_future();
+
+    {
+        auto lock = std::unique_lock { m_mutex };
+        m_queue.emplace_back(std::move(transfer));
+    }
+
+    curl_multi_wakeup(m_multi);
+
+    return future;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Downloader::stats() const -> Stats {
+    auto lock = std::unique_lock { m_mutex };
+
+    return Stats { .completed   = m_completed.load(std::memory_order_relaxed),
+                   .failed      = m_failed.load(std::memory_order_relaxed),
+                   .bytes       = m_bytes.load(std::memory_order_relaxed),
+                   .connections = m_connections.load(std::memory_order_relaxed),
+                   .running     = m_running.load(std::memory_order_relaxed),
+                   .queued      = std::size(m_queue) };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Downloader::onData(char *data, std::size_t size, std::size_t count, void *user_data)
+    -> std::size_t {
+    auto &transfer    = *static_cast<Transfer *>(user_data);
+    const auto length = size * count;
+
+    // the headers are known once the first chunk of the body arrives
+    if (!std::exchange(transfer.sized, true) && !transfer.request.on_data) {
+        auto content_length = curl_off_t { -1 };
+        curl_easy_getinfo(transfer.handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+
+        if (content_length > 0)
+            transfer.result.body.reserve(
+                std::min(static_cast<std::size_t>(content_length), transfer.max_size));
+    }
+
+    // CURLOPT_MAXFILESIZE only covers responses announcing their size
+    if (transfer.result.size + length > transfer.max_size) {
+        transfer.too_large = true;
+        return CURL_WRITEFUNC_ERROR;
+    }
+
+    transfer.result.size += length;
+
+    if (transfer.request.on_data) {
+        if (transfer.request.on_data(std::string_view { data, length })) return length;
+
+        transfer.aborted = true;
+        return CURL_WRITEFUNC_ERROR;
+    }
+
+    transfer.result.body.append(data, length);
+
+    return length;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Downloader::work(std::stop_token token) -> void {
+    while (!token.stop_requested()) {
+        auto running = 0;
+        curl_multi_perform(m_multi, &running);
+
+        auto pending = 0;
+        while (auto *message = curl_multi_info_read(m_multi, &pending))
+            if (message->msg == CURLMSG_DONE) finish(message->easy_handle, message->data.result);
+
+        {
+            auto lock = std::unique_lock { m_mutex };
+            while (!std::empty(m_queue) && std::size(m_transfers) < m_settings.parallel) {
+                start(std::move(m_queue.front()));
+                m_queue.pop_front();
+            }
+        }
+
+        m_running.store(std::size(m_transfers), std::memory_order_relaxed);
+
+        curl_multi_poll(m_multi, nullptr, 0, POLL_TIMEOUT, nullptr);
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Downloader::start(std::unique_ptr<Transfer> transfer) -> void {
+    auto *handle = static_cast<CURL *>(nullptr);
+    if (!std::empty(m_idle_handles)) {
+        handle = m_idle_handles.back();
+        m_idle_handles.pop_back();
+
+        // keeps the connection and dns caches
+        curl_easy_reset(handle);
+    } else
+        handle = curl_easy_init();
+
+    transfer->handle = handle;
+
+    const auto max_size        = static_cast<curl_off_t>(transfer->max_size);
+    const auto timeout         = static_cast<long>(transfer->timeout.count());
+    const auto connect_timeout = static_cast<long>(m_settings.connect_timeout.count());
+
+    curl_easy_setopt(handle, CURLOPT_URL, transfer->request.url.c_str());
+    curl_easy_setopt(handle, CURLOPT_PROTOCOLS_STR, "http,https");
+    curl_easy_setopt(handle, CURLOPT_REDIR_PROTOCOLS_STR, "http,https");
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(handle, CURLOPT_MAXREDIRS, MAX_REDIRECTS);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(handle, CURLOPT_USERAGENT, "Inquisitor");
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, timeout);
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, connect_timeout);
+    curl_easy_setopt(handle, CURLOPT_MAXFILESIZE_LARGE, max_size);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, onData);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, transfer.get());
+    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, std::data(transfer->error));
+
+    curl_multi_add_handle(m_multi, handle);
+
+    m_transfers.emplace_back(std::move(transfer));
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Downloader::finish(CURL *handle, CURLcode code) -> void {
+    curl_multi_remove_handle(m_multi, handle);
+
+    const auto it = std::ranges::find_if(m_transfers, [handle](const auto &transfer) {
+        return transfer->handle == handle;
+    });
+    auto transfer = std::move(*it);
+    m_transfers.erase(it);
+
+    auto &result = transfer->result;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &result.status);
+
+    auto connections = 0L;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connections);
+    m_connections.fetch_add(static_cast<core::UInt64>(connections), std::memory_order_relaxed);
+
+    if (transfer->too_large || code == CURLE_FILESIZE_EXCEEDED)
+        result.error = std::format("larger than {} bytes", transfer->max_size);
+    else if (transfer->aborted)
+        result.error = "aborted by the data callback";
+    else if (code != CURLE_OK)
+        result.error = (transfer->error[0] != '\0') ? std::string { std::data(transfer->error) }
+                                                     : curl_easy_strerror(code);
+
+    m_idle_handles.emplace_back(handle);
+
+    auto &counter = result.ok() ? m_completed : m_failed;
+    counter.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(result.size, std::memory_order_relaxed);
+
+    transfer->promise.set_value(std::move(result));
+}
@@ -0,0 +1,81 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+#include "Settings.hpp"
+
+#include <curl/curl.h>
+
+// HTTP downloads driven by one curl multi handle on its own thread. Connections and easy handles
+// are reused across requests, at most settings.parallel transfers run at once
+class Downloader {
+  public:
+    using Request = CoreServices::DownloadRequest;
+    using Result  = CoreServices::DownloadResult;
+
+    struct Stats {
+        stormkit::core::UInt64 completed;
+        stormkit::core::UInt64 failed;
+        stormkit::core::UInt64 bytes;
+        // connections opened, the others were reused
+        stormkit::core::UInt64 connections;
+        std::size_t running;
+        std::size_t queued;
+    };
+
+    // curl_global_init() must have been called
+    explicit Downloader(Settings::Downloads settings);
+    // transfers which didn't complete fail with an error
+    ~Downloader();
+
+    Downloader(const Downloader &)                     = delete;
+    auto operator=(const Downloader &) -> Downloader & = delete;
+
+    auto download(Request request) -> std::future<Result>;
+
+    [[nodiscard]] auto stats() const -> Stats;
+
+  private:
+    struct Transfer {
+        Request request;
+        std::promise<Result> promise;
+        Result result;
+
+        std::size_t max_size;
+        std::chrono::milliseconds timeout;
+        CURL *handle = nullptr;
+
+        bool sized     = false;
+        bool too_large = false;
+        bool aborted   = false;
+        std::array<char, CURL_ERROR_SIZE> error {};
+    };
+
+    static auto onData(char *data, std::size_t size, std::size_t count, void *user_data)
+        -> std::size_t;
+
+    auto work(std::stop_token token) -> void;
+    auto start(std::unique_ptr<Transfer> transfer) -> void;
+    auto finish(CURL *handle, CURLcode code) -> void;
+
+    Settings::Downloads m_settings;
+
+    CURLM *m_multi;
+    // only touched by the download thread
+    std::vector<CURL *> m_idle_handles;
+    std::vector<std::unique_ptr<Transfer>> m_transfers;
+
+    mutable std::mutex m_mutex;
+    std::deque<std::unique_ptr<Transfer>> m_queue;
+
+    std::atomic<stormkit::core::UInt64> m_completed   = 0;
+    std::atomic<stormkit::core::UInt64> m_failed      = 0;
+    std::atomic<stormkit::core::UInt64> m_bytes       = 0;
+    std::atomic<stormkit::core::UInt64> m_connections = 0;
+    std::atomic<std::size_t> m_running                = 0;
+
+    std::jthread m_thread;
+};
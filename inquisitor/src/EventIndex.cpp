@@ -0,0 +1,79 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "EventIndex.hpp"
+
+using Subscription = PluginInterface::Subscription;
+
+/////////////////////////////////////
+/////////////////////////////////////
+EventIndex::EventIndex() noexcept = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+EventIndex::EventIndex(std::span<const Subscription> subscriptions) {
+    if (std::size(subscriptions) > MAX_PLUGINS) {
+        elog("Event index only supports {} plugins, {} given, extra plugins won't receive events",
+             MAX_PLUGINS,
+             std::size(subscriptions));
+        subscriptions = subscriptions.first(MAX_PLUGINS);
+    }
+
+    for (auto i = 0u; i < std::size(subscriptions); ++i) {
+        const auto &subscription = subscriptions[i];
+        const auto bit           = Mask { 1 } << i;
+
+        if (subscription.events & Subscription::READY) m_ready |= bit;
+        if (!(subscription.events & Subscription::MESSAGE)) continue;
+
+        m_message |= bit;
+
+        if (subscription.ignore_own_messages) m_ignore_own |= bit;
+
+        if (subscription.channels)
+            for (const auto id : *subscription.channels)
+                m_channels[static_cast<std::uint64_t>(id)] |= bit;
+        else
+            m_any_channel |= bit;
+
+        if (subscription.guilds)
+            for (const auto id : *subscription.guilds)
+                m_guilds[static_cast<std::uint64_t>(id)] |= bit;
+        else
+            m_any_guild |= bit;
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+EventIndex::~EventIndex() = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+EventIndex::EventIndex(EventIndex &&) noexcept = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto EventIndex::operator=(EventIndex &&) noexcept -> EventIndex & = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto EventIndex::messageTargets(dpp::snowflake channel_id,
+                                dpp::snowflake guild_id,
+                                bool own_message) const noexcept -> Mask {
+    auto channel_mask = m_any_channel;
+    if (const auto it = m_channels.find(static_cast<std::uint64_t>(channel_id));
+        it != std::ranges::cend(m_channels))
+        channel_mask |= it->second;
+
+    auto guild_mask = m_any_guild;
+    if (const auto it = m_guilds.find(static_cast<std::uint64_t>(guild_id));
+        it != std::ranges::cend(m_guilds))
+        guild_mask |= it->second;
+
+    auto mask = m_message & channel_mask & guild_mask;
+    if (own_message) mask &= ~m_ignore_own;
+
+    return mask;
+}
@@ -0,0 +1,47 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+#include <ankerl/unordered_dense.h>
+
+class EventIndex {
+  public:
+    using Mask = std::uint64_t;
+
+    static constexpr auto MAX_PLUGINS = std::numeric_limits<Mask>::digits;
+
+    EventIndex() noexcept;
+    explicit EventIndex(std::span<const PluginInterface::Subscription> subscriptions);
+    ~EventIndex();
+
+    EventIndex(EventIndex &&) noexcept;
+    auto operator=(EventIndex &&) noexcept -> EventIndex &;
+
+    [[nodiscard]] auto readyTargets() const noexcept -> Mask { return m_ready; }
+    [[nodiscard]] auto messageTargets(dpp::snowflake channel_id,
+                                      dpp::snowflake guild_id,
+                                      bool own_message) const noexcept -> Mask;
+
+    template<typename Func>
+    static auto forEach(Mask mask, Func &&func) -> void {
+        for (; mask != 0; mask &= mask - 1)
+            std::invoke(func, static_cast<std::size_t>(std::countr_zero(mask)));
+    }
+
+  private:
+    using SnowflakeMasks = ankerl::unordered_dense::map<std::uint64_t, Mask>;
+
+    Mask m_ready   = 0;
+    Mask m_message = 0;
+
+    Mask m_any_channel = 0;
+    Mask m_any_guild   = 0;
+    Mask m_ignore_own  = 0;
+
+    SnowflakeMasks m_channels;
+    SnowflakeMasks m_guilds;
+};
@@ -0,0 +1,57 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "EventLog.hpp"
+
+using namespace stormkit;
+
+/////////////////////////////////////
+/////////////////////////////////////
+EventLogWriter::EventLogWriter(const std::filesystem::path &path)
+    : m_stream { path, std::ios::binary | std::ios::app } {
+    if (!m_stream) elog("Failed to open event log {}", path.string());
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto EventLogWriter::write(std::string_view payload) -> void {
+    const auto size = static_cast<core::UInt32>(std::size(payload));
+
+    const auto header = std::array { static_cast<char>(size & 0xff),
+                                     static_cast<char>((size >> 8) & 0xff),
+                                     static_cast<char>((size >> 16) & 0xff),
+                                     static_cast<char>((size >> 24) & 0xff) };
+
+    auto lock = std::unique_lock { m_mutex };
+
+    m_stream.write(std::data(header), std::size(header));
+    m_stream.write(std::data(payload), size);
+    m_stream.flush();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+EventLogReader::EventLogReader(const std::filesystem::path &path)
+    : m_stream { path, std::ios::binary } {
+    if (!m_stream) elog("Failed to open event log {}", path.string());
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto EventLogReader::next() -> std::optional<std::string> {
+    auto header = std::array<unsigned char, 4> {};
+    if (!m_stream.read(reinterpret_cast<char *>(std::data(header)), std::size(header)))
+        return std::nullopt;
+
+    const auto size = core::UInt32 { header[0] } | (core::UInt32 { header[1] } << 8) |
+                      (core::UInt32 { header[2] } << 16) | (core::UInt32 { header[3] } << 24);
+
+    auto payload = std::string(size, '\0');
+    if (!m_stream.read(std::data(payload), size)) {
+        wlog("Truncated event log entry, stopping there");
+        return std::nullopt;
+    }
+
+    return payload;
+}
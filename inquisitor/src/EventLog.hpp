@@ -0,0 +1,30 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Raw gateway dispatch payloads, each one stored as a little endian UInt32 size followed by the
+// payload itself
+class EventLogWriter {
+  public:
+    explicit EventLogWriter(const std::filesystem::path &path);
+
+    auto write(std::string_view payload) -> void;
+
+  private:
+    std::mutex m_mutex;
+    std::ofstream m_stream;
+};
+
+class EventLogReader {
+  public:
+    explicit EventLogReader(const std::filesystem::path &path);
+
+    [[nodiscard]] auto next() -> std::optional<std::string>;
+
+  private:
+    std::ifstream m_stream;
+};
@@ -0,0 +1,211 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Executor.hpp"
+
+using namespace stormkit;
+
+namespace {
+    thread_local Executor *t_current = nullptr;
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+Executor::Executor(std::string name, Settings settings)
+    : m_name { std::move(name) }, m_settings { std::move(settings) },
+      m_total_wait { Clock::duration::zero() }, m_max_wait { Clock::duration::zero() },
+      m_busy { Clock::duration::zero() } {
+    m_settings.threads    = std::max(m_settings.threads, 1u);
+    m_settings.queue_size = std::max<std::size_t>(m_settings.queue_size, 1u);
+
+    m_workers.reserve(m_settings.threads);
+    for (auto i = 0u; i < m_settings.threads; ++i)
+        m_workers.emplace_back([this](std::stop_token token) { work(std::move(token)); });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Executor::~Executor() {
+    for (auto &worker : m_workers) worker.request_stop();
+
+    auto lock  = std::unique_lock { m_mutex };
+    m_stopping = true;
+    m_not_full.notify_all();
+
+    // producers blocked by the BLOCK policy return before the members go away
+    m_not_full.wait(lock, [this] { return m_blocked == 0; });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::post(Task task) -> bool {
+    auto lock = std::unique_lock { m_mutex };
+    if (m_stopping) return false;
+
+    if (std::size(m_queue) >= m_settings.queue_size) {
+        switch (m_settings.overflow) {
+            case OverflowPolicy::DROP_NEW: ++m_dropped; return false;
+            case OverflowPolicy::DROP_OLDEST: {
+                ++m_dropped;
+
+                // continuations are never dropped, their coroutine would leak suspended
+                const auto oldest = std::ranges::find(m_queue, true, &Item::droppable);
+                if (oldest == std::ranges::end(m_queue)) return false;
+
+                m_queue.erase(oldest);
+                break;
+            }
+            case OverflowPolicy::BLOCK:
+                ++m_blocked;
+                m_not_full.wait(lock, [this] {
+                    return m_stopping || std::size(m_queue) < m_settings.queue_size;
+                });
+                --m_blocked;
+
+                if (m_stopping) {
+                    m_not_full.notify_all();
+                    return false;
+                }
+                break;
+        }
+    }
+
+    m_queue.emplace_back(Item { std::move(task), Clock::now(), true });
+
+    lock.unlock();
+    m_not_empty.notify_one();
+
+    return true;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::postContinuation(Task task) -> void {
+    auto lock = std::unique_lock { m_mutex };
+    m_queue.emplace_back(Item { std::move(task), Clock::now(), false });
+
+    lock.unlock();
+    m_not_empty.notify_one();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::postExclusive(Task task) -> void {
+    auto lock = std::unique_lock { m_mutex };
+    m_queue.emplace_back(Item { std::move(task), Clock::now(), false, true });
+
+    lock.unlock();
+    m_not_empty.notify_one();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::waitIdle() -> void {
+    auto lock = std::unique_lock { m_mutex };
+
+    m_idle.wait(lock,
+                [this] { return std::empty(m_queue) && m_running == 0 && !m_exclusive; });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::stats() const -> Stats {
+    auto lock = std::unique_lock { m_mutex };
+
+    const auto average_wait =
+        (m_executed > 0) ? m_total_wait / static_cast<Clock::rep>(m_executed)
+                         : Clock::duration::zero();
+
+    return Stats { .depth        = std::size(m_queue),
+                   .executed     = m_executed,
+                   .dropped      = m_dropped,
+                   .average_wait = std::chrono::duration_cast<std::chrono::microseconds>(average_wait),
+                   .max_wait     = std::chrono::duration_cast<std::chrono::microseconds>(m_max_wait),
+                   .busy         = std::chrono::duration_cast<std::chrono::microseconds>(m_busy) };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::current() noexcept -> Executor * {
+    return t_current;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::parseSettings(const nlohmann::json &options) -> Settings {
+    auto settings = Settings {};
+
+    if (!options.is_object()) return settings;
+
+    if (options.contains("threads")) settings.threads = options["threads"].get<core::UInt32>();
+    if (options.contains("queue_size"))
+        settings.queue_size = options["queue_size"].get<std::size_t>();
+
+    if (options.contains("overflow")) {
+        const auto overflow = options["overflow"].get<std::string>();
+
+        if (overflow == "drop_oldest") settings.overflow = OverflowPolicy::DROP_OLDEST;
+        else if (overflow == "drop_new")
+            settings.overflow = OverflowPolicy::DROP_NEW;
+        else if (overflow == "block")
+            settings.overflow = OverflowPolicy::BLOCK;
+        else
+            elog("Unknown executor overflow policy \"{}\", using drop_oldest", overflow);
+    }
+
+    return settings;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Executor::work(std::stop_token token) -> void {
+    t_current = this;
+
+    while (!token.stop_requested()) {
+        auto lock = std::unique_lock { m_mutex };
+        if (!m_not_empty.wait(lock, token, [this] {
+                return !std::empty(m_queue) && !m_exclusive;
+            }))
+            return;
+
+        auto item = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        // the other workers stop taking tasks meanwhile
+        if (item.exclusive) {
+            m_exclusive = true;
+            m_idle.wait(lock, [this] { return m_running == 0; });
+        }
+
+        const auto wait = Clock::now() - item.enqueued_at;
+        m_total_wait += wait;
+        m_max_wait = std::max(m_max_wait, wait);
+        ++m_executed;
+        ++m_running;
+
+        lock.unlock();
+        m_not_full.notify_one();
+
+        const auto start = Clock::now();
+
+        try {
+            item.task();
+        } catch (const std::exception &e) { elog("{} task failed, reason: {}", m_name, e.what()); }
+
+        // captures may post continuations on release, don't hold the lock meanwhile
+        item.task = nullptr;
+
+        lock.lock();
+        m_busy += Clock::now() - start;
+        --m_running;
+
+        if (item.exclusive) {
+            m_exclusive = false;
+            m_not_empty.notify_all();
+        }
+
+        // also wakes a worker waiting to run an exclusive task
+        if (m_running == 0) m_idle.notify_all();
+    }
+}
@@ -0,0 +1,94 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Runs the callbacks of one plugin on its own worker threads, so a slow plugin only delays itself
+class Executor {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Task  = std::move_only_function<void()>;
+
+    enum class OverflowPolicy {
+        DROP_OLDEST,
+        DROP_NEW,
+        BLOCK,
+    };
+
+    struct Settings {
+        stormkit::core::UInt32 threads = 1;
+        std::size_t queue_size         = 256;
+        OverflowPolicy overflow        = OverflowPolicy::DROP_OLDEST;
+    };
+
+    struct Stats {
+        std::size_t depth;
+        std::size_t executed;
+        std::size_t dropped;
+        std::chrono::microseconds average_wait;
+        std::chrono::microseconds max_wait;
+        // time spent running tasks
+        std::chrono::microseconds busy;
+    };
+
+    Executor(std::string name, Settings settings);
+    ~Executor();
+
+    Executor(const Executor &)                    = delete;
+    auto operator=(const Executor &) -> Executor & = delete;
+
+    // returns false if the task was dropped or the executor is being destroyed
+    auto post(Task task) -> bool;
+    // bypasses the queue bound and is never dropped, for work which must run (coroutine
+    // resumption)
+    auto postContinuation(Task task) -> void;
+    // never dropped either, runs once the tasks already running returned and no other task
+    // starts until it did
+    auto postExclusive(Task task) -> void;
+
+    // blocks until the queue is empty and no task is running
+    auto waitIdle() -> void;
+
+    [[nodiscard]] auto name() const noexcept -> const std::string & { return m_name; }
+    [[nodiscard]] auto settings() const noexcept -> const Settings & { return m_settings; }
+    [[nodiscard]] auto stats() const -> Stats;
+
+    [[nodiscard]] static auto current() noexcept -> Executor *;
+
+    [[nodiscard]] static auto parseSettings(const nlohmann::json &options) -> Settings;
+
+  private:
+    struct Item {
+        Task task;
+        Clock::time_point enqueued_at;
+        bool droppable;
+        bool exclusive = false;
+    };
+
+    auto work(std::stop_token token) -> void;
+
+    std::string m_name;
+    Settings m_settings;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_not_empty;
+    std::condition_variable_any m_not_full;
+    std::condition_variable_any m_idle;
+    std::deque<Item> m_queue;
+
+    bool m_stopping       = false;
+    bool m_exclusive      = false;
+    std::size_t m_blocked = 0;
+
+    std::size_t m_running  = 0;
+    std::size_t m_executed = 0;
+    std::size_t m_dropped  = 0;
+    Clock::duration m_total_wait;
+    Clock::duration m_max_wait;
+    Clock::duration m_busy;
+
+    std::vector<std::jthread> m_workers;
+};
@@ -0,0 +1,52 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "GatewayStats.hpp"
+
+/////////////////////////////////////
+/////////////////////////////////////
+GatewayStats::GatewayStats() = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+GatewayStats::~GatewayStats() = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto GatewayStats::record(std::string_view type, const std::string &raw) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        static_cast<void>(nlohmann::json::parse(raw));
+    } catch (const std::exception &e) { dlog("Failed to decode {} payload, {}", type, e.what()); }
+    const auto decode = std::chrono::steady_clock::now() - start;
+
+    auto lock      = std::unique_lock { m_mutex };
+    auto &counters = m_counters[type];
+
+    ++counters.count;
+    counters.bytes += std::size(raw);
+    counters.decode += decode;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto GatewayStats::entries() const -> std::vector<Entry> {
+    auto entries = std::vector<Entry> {};
+
+    {
+        auto lock = std::unique_lock { m_mutex };
+        entries.reserve(std::size(m_counters));
+
+        for (const auto &[type, counters] : m_counters)
+            entries.emplace_back(Entry {
+                type,
+                counters.count,
+                counters.bytes,
+                std::chrono::duration_cast<std::chrono::microseconds>(counters.decode) });
+    }
+
+    std::ranges::sort(entries, std::ranges::greater {}, &Entry::bytes);
+
+    return entries;
+}
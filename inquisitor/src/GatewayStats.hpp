@@ -0,0 +1,42 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Inbound bytes and decode time per gateway event type, only filled when gateway.measure is set.
+// dpp doesn't expose its own decode time, so every payload is parsed a second time and that time
+// is recorded instead
+class GatewayStats {
+  public:
+    struct Entry {
+        std::string_view type;
+        std::size_t count;
+        std::size_t bytes;
+        std::chrono::microseconds decode;
+    };
+
+    GatewayStats();
+    ~GatewayStats();
+
+    GatewayStats(const GatewayStats &)                    = delete;
+    auto operator=(const GatewayStats &) -> GatewayStats & = delete;
+
+    // type must outlive the stats, raw is the decompressed payload
+    auto record(std::string_view type, const std::string &raw) -> void;
+
+    // sorted by decreasing bytes
+    [[nodiscard]] auto entries() const -> std::vector<Entry>;
+
+  private:
+    struct Counters {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+        std::chrono::nanoseconds decode { 0 };
+    };
+
+    mutable std::mutex m_mutex;
+    stormkit::core::HashMap<std::string_view, Counters> m_counters;
+};
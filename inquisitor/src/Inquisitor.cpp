@@ -6,12 +6,220 @@
 
 #include <curl/curl.h>
 
+#if defined(__linux__)
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
 #pragma push_macro("interface")
 #undef interface
 
 using namespace std::literals;
 using namespace stormkit;
 
+namespace {
+    // dpp only lends the message for the duration of the handler, plugins run later on their
+    // executor so every message is copied once and shared by the message cache and all the
+    // targets. What the core builds for it lives in the event arena
+    struct MessageEvent {
+        // dpp 9 events point to a mutable message, the cache only hands it out as const
+        MessageEvent(const dpp::message_create_t &event, std::shared_ptr<dpp::message> message)
+            : message { std::move(message) }, create_event { event } {
+            create_event.msg = this->message.get();
+        }
+
+        // the view points into message and matches, the event is never moved once shared
+        auto buildView(dpp::snowflake own_id) -> void {
+            attachments.reserve(std::size(message->attachments));
+            for (const auto &attachment : message->attachments)
+                attachments.emplace_back(MessageView::Attachment { attachment.id,
+                                                                   attachment.filename,
+                                                                   attachment.content_type,
+                                                                   attachment.url,
+                                                                   attachment.size });
+
+            const auto author_id = message->author ? message->author->id : dpp::snowflake {};
+
+            auto author_name = std::string_view { message->member.nickname };
+            if (std::empty(author_name) && message->author)
+                author_name = message->author->username;
+
+            view = MessageView { .id          = message->id,
+                                 .channel_id  = message->channel_id,
+                                 .guild_id    = message->guild_id,
+                                 .author_id   = author_id,
+                                 .content     = message->content,
+                                 .author_name = author_name,
+                                 .attachments = attachments,
+                                 .has_url     = !std::empty(matches.urls),
+                                 .own_message = author_id == own_id,
+                                 .matches     = &matches,
+                                 .event       = &create_event,
+                                 .scratch     = nullptr };
+        }
+
+        Arena arena;
+
+        std::shared_ptr<dpp::message> message;
+        dpp::message_create_t create_event;
+        MessageScanner::Matches matches { &arena };
+
+        std::pmr::vector<MessageView::Attachment> attachments { &arena };
+        MessageView view = {};
+
+        Tracer::TraceID trace_id = 0;
+        Tracer::Slice slice;
+    };
+
+    struct CommandEvent {
+        dpp::interaction_create_t event;
+
+        Tracer::TraceID trace_id = 0;
+        Tracer::Slice slice;
+    };
+
+    // keeps a detached handler's event and plugin instance alive until its coroutine completes,
+    // the callback trace slice and scratch memory end with it
+    struct InFlight {
+        std::shared_ptr<const void> event;
+        std::shared_ptr<PluginInterface> plugin;
+        Tracer::Slice slice;
+
+        Arena scratch;
+        MessageView view = {};
+    };
+
+    constexpr auto EXECUTOR_STATS_INTERVAL = 60;
+    constexpr auto REAP_INTERVAL           = 5;
+    constexpr auto SESSION_SAVE_INTERVAL   = 10;
+    constexpr auto WATCH_POLL_TIMEOUT      = 250;
+    constexpr auto DRAIN_TIMEOUT           = 10s;
+    // max_concurrency identifies are allowed per interval, resumes aren't limited
+    constexpr auto IDENTIFY_INTERVAL = 5s;
+
+    constexpr auto RELOAD_COMMAND          = "reload";
+    constexpr auto RELOAD_SETTINGS_COMMAND = "reload_settings";
+    constexpr auto TRACE_COMMAND           = "trace";
+
+    const auto NO_OPTIONS = json::object();
+
+    // pin is released once func is destroyed
+    template<typename Func>
+    struct Pinned {
+        std::shared_ptr<void> pin;
+        Func func;
+
+        auto operator()(auto &&...args) { return func(std::forward<decltype(args)>(args)...); }
+    };
+
+    // instance whose code runs on the calling thread, see InstanceContext
+    thread_local auto t_instance = std::shared_ptr<PluginInterface> {};
+
+    // makes instance the one of the calling thread until destroyed, the requests it sends
+    // meanwhile keep it alive
+    class InstanceContext {
+      public:
+        explicit InstanceContext(std::shared_ptr<PluginInterface> instance) noexcept
+            : m_previous { std::exchange(t_instance, std::move(instance)) } {}
+        ~InstanceContext() { t_instance = std::move(m_previous); }
+
+        InstanceContext(const InstanceContext &)                    = delete;
+        auto operator=(const InstanceContext &) -> InstanceContext & = delete;
+
+      private:
+        std::shared_ptr<PluginInterface> m_previous;
+    };
+
+    // the cluster of a replay can't act on the bot account, the requests plugins issue on it
+    // directly are refused by Discord
+    constexpr auto REPLAY_TOKEN = "replay";
+
+    // empty value of the type a request of that name completes with, std::nullopt when unknown
+    auto replayResult(std::string_view name) -> std::optional<dpp::confirmable_t> {
+        if (name == "message_get" || name == "message_create") return dpp::message {};
+        if (name == "channel_get") return dpp::channel {};
+        if (name == "thread_create_with_message") return dpp::thread {};
+        if (name == "interaction_response" || name == "message_add_reaction" ||
+            name == "message_delete" || name == "message_delete_bulk")
+            return dpp::confirmation {};
+
+        return std::nullopt;
+    }
+
+    auto toVector(const dpp::slashcommand_map &map) -> std::vector<dpp::slashcommand> {
+        auto commands = std::vector<dpp::slashcommand> {};
+        commands.reserve(std::size(map));
+
+        for (const auto &[_, command] : map) commands.emplace_back(command);
+
+        return commands;
+    }
+
+    // a string choice whose value is its name
+    auto choiceOf(const std::string &name) -> dpp::command_option_choice {
+        return dpp::command_option_choice { name, name };
+    }
+
+    // reads the plugin name from its sidecar manifest, or from its pluginName() export, without
+    // constructing it
+    auto probePluginName(const std::filesystem::path &path) -> std::optional<std::string> {
+        auto manifest_path = path;
+        manifest_path.replace_extension(".json");
+
+        if (std::filesystem::exists(manifest_path)) {
+            try {
+                auto file = std::ifstream { manifest_path };
+
+                return nlohmann::json::parse(file).at("name").get<std::string>();
+            } catch (const std::exception &e) {
+                wlog("Invalid plugin manifest {}, reason: {}", manifest_path.string(), e.what());
+            }
+        }
+
+        auto res = core::DynamicLoader::load(path);
+        if (!res) {
+            elog("Failed to load plugin {}", res.error().message());
+            return std::nullopt;
+        }
+
+        auto &&loader = res.value();
+        auto res2     = loader.func<const char *()>("pluginName");
+        if (!res2) {
+            elog("Plugin {} doesn't export pluginName(), rebuild it against this api",
+                 path.string());
+            return std::nullopt;
+        }
+
+        auto &&name_func = res2.value();
+
+        return std::string { name_func() };
+    }
+
+    auto elapsedSince(std::chrono::steady_clock::time_point start) noexcept {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+    }
+
+    // snowflakes embed their creation time, which is the closest we get to the gateway send time
+    auto ingestLatency(dpp::snowflake id) noexcept {
+        const auto created = std::chrono::duration<double> { id.get_creation_time() };
+        const auto now     = std::chrono::system_clock::now().time_since_epoch();
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(now - created);
+    }
+
+    auto logTaskError(std::string_view plugin_name) {
+        return [plugin_name](std::exception_ptr exception) {
+            try {
+                std::rethrow_exception(exception);
+            } catch (const std::exception &e) {
+                elog("{} handler failed, reason: {}", plugin_name, e.what());
+            }
+        };
+    }
+} // namespace
+
 static constexpr auto ASCII_ART_LOGO =
     "\nmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm"
     "mmmmmmmm"
@@ -100,7 +308,8 @@ static auto curlWriteData(void *ptr, std::size_t size, std::size_t nmemb, void *
 
 /////////////////////////////////////
 /////////////////////////////////////
-Inquisitor::Inquisitor() noexcept {
+Inquisitor::Inquisitor(core::UInt32 cluster_id, Mode mode)
+    : m_cluster_id { cluster_id }, m_mode { mode } {
     core::print(ASCII_ART_LOGO);
     ilog("Using StormKit {}.{}.{} {} {}",
          core::STORMKIT_MAJOR_VERSION,
@@ -110,10 +319,79 @@ Inquisitor::Inquisitor() noexcept {
          core::STORMKIT_GIT_COMMIT_HASH);
 
     curl_global_init(CURL_GLOBAL_ALL);
-    parseSettings();
+
+    auto start = StartupReport::Clock::now();
+    m_settings.publish(parseSettings());
+    m_startup.record("settings", "", start);
+
+    start = StartupReport::Clock::now();
     loadPlugins();
+    m_startup.record("load", "", start);
+
+    const auto snapshot  = m_settings.get();
+    const auto &settings = *snapshot;
+    if (!validatePluginOptions(settings, nullptr))
+        throw InvalidOptions { std::format("{} has invalid plugin options", Settings::PATH) };
+    preparePlugins();
+
+    if (settings.record_events && m_mode == Mode::GATEWAY) {
+        ilog("Recording gateway events to {}", settings.record_events->string());
+        m_recorder = std::make_unique<EventLogWriter>(*settings.record_events);
+    }
 
-    m_bot = std::make_unique<dpp::cluster>(m_token);
+    m_message_cache = std::make_unique<MessageCache>(settings.message_cache_budget);
+    m_downloader    = std::make_unique<Downloader>(settings.downloads);
+
+    m_tracer = std::make_unique<Tracer>(settings.tracing.buffer_size);
+    m_tracer->configure(settings.tracing.enabled, settings.tracing.sample_every);
+
+    if (!settings.session_file.empty() && m_mode == Mode::GATEWAY) {
+        auto path = settings.session_file;
+        if (m_cluster_id != 0)
+            path.replace_extension(
+                std::format("{}{}", m_cluster_id, settings.session_file.extension().string()));
+
+        m_session_store = std::make_unique<SessionStore>(std::move(path));
+    }
+
+    if (settings.sharding.clusters > 1)
+        ilog("Running cluster {}/{}", m_cluster_id + 1, settings.sharding.clusters);
+
+    // the core itself only needs the guilds, anything else is requested by the plugins
+    m_intents = dpp::i_guilds;
+    for (const auto &plugin : m_plugins) m_intents |= plugin->instance.load()->intents();
+
+    ilog("Connecting with intents {:#x}{}",
+         m_intents,
+         settings.gateway.compression ? ", zlib-stream compression" : "");
+
+    m_bot = std::make_unique<dpp::cluster>((m_mode == Mode::REPLAY) ? REPLAY_TOKEN
+                                                                     : settings.token,
+                                           m_intents,
+                                           settings.sharding.shards,
+                                           m_cluster_id,
+                                           settings.sharding.clusters,
+                                           settings.gateway.compression,
+                                           cachePolicy(settings.cache));
+
+    m_outbound = std::make_unique<Outbound>(*m_bot, *this);
+
+    if (settings.gateway.measure && m_mode == Mode::GATEWAY) measureGateway();
+
+    // the guilds are sampled from the shard thread which updates them
+    m_cache_budget = std::make_unique<CacheBudget>(settings.cache.budget);
+    m_bot->on_guild_create([this](const auto &event) {
+        if (event.created) m_cache_budget->sample(event.created->id);
+    });
+    m_bot->on_guild_member_add([this](const auto &event) {
+        if (event.adding_guild) m_cache_budget->sample(event.adding_guild->id);
+    });
+    m_bot->on_message_create([this](const auto &event) {
+        if (event.msg->guild_id) m_cache_budget->sample(event.msg->guild_id);
+    });
+    m_bot->on_guild_delete([this](const auto &event) {
+        if (event.deleted) m_cache_budget->forget(event.deleted->id);
+    });
 
     m_bot->on_log([](const auto &event) {
         switch (event.severity) {
@@ -126,29 +404,99 @@ Inquisitor::Inquisitor() noexcept {
         }
     });
 
+    // the dispatch of a resumed session was installed by run() before connecting
+    m_bot->on_resumed(
+        [](const auto &event) { ilog("shard {} resumed its session", event.shard_id); });
+
     m_bot->on_ready([this](const auto &event) {
+        if (m_recorder) m_recorder->write(event.raw_event);
+
         ilog("logged as \"{}\"", m_bot->me.username);
 
-        initializeBot();
+        // dpp wrote the session and the user from this shard thread right before
+        if (event.from) {
+            auto lock           = std::unique_lock { m_sessions_mutex };
+            m_sessions.user_id  = m_bot->me.id;
+            m_sessions.username = m_bot->me.username;
+            m_sessions.shards[event.from->shard_id] =
+                SessionStore::Shard { .session_id = event.session_id,
+                                      .sequence   = event.from->last_seq };
+        }
+
+        // plugins initialized by this READY receive it from initializePlugin()
+        const auto index    = m_event_index.get();
+        const auto  targets = index ? index->readyTargets() : EventIndex::Mask { 0 };
+
+        std::call_once(m_initialized, [this, &event] { initializeBot(event); });
+        if (targets == 0) return;
+
+        const auto trace_id = m_tracer->startTrace();
+        auto slice          = std::make_shared<const Tracer::Slice>(
+            m_tracer->slice(trace_id, 0, "gateway", "READY"));
+
+        EventIndex::forEach(targets, [&](auto i) {
+            auto &plugin = *m_plugins[i];
+            plugin.executor->post([this, event, trace_id, slice, &plugin] {
+                const auto start = std::chrono::steady_clock::now();
+                const auto callback =
+                    m_tracer->slice(trace_id, slice->id(), "onReady", plugin.name);
+                const auto context = Tracer::Context { trace_id, callback.id() };
+
+                const auto instance = plugin.instance.load();
+                const auto owner    = InstanceContext { instance };
+                instance->onReady(event, *m_bot);
 
-        for (auto &plugin : m_plugins) { plugin.interface->onReady(event, *m_bot); }
+                plugin.latencies.ready.record(elapsedSince(start));
+            });
+        });
     });
+
+    m_bot->start_timer(
+        [this](auto) {
+            logExecutorStats();
+            logLatencies();
+            logRequestStats();
+            logMessageCacheStats();
+            logGatewayStats();
+            logCacheStats();
+            logDownloadStats();
+        },
+        EXECUTOR_STATS_INTERVAL);
+
+    if (settings.metrics_port != 0 && m_mode == Mode::GATEWAY)
+        m_metrics_server =
+            std::make_unique<MetricsServer>(settings.metrics_port, [this] { return metricsReport(); });
+    m_bot->start_timer([this](auto) { reapRetiredPlugins(); }, REAP_INTERVAL);
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
 Inquisitor::~Inquisitor() {
+    m_plugin_watcher = {};
+
     for (auto &plugin : m_plugins) {
-        auto res = plugin.loader.func<void(PluginInterface *)>("deallocatePlugin");
-        if (res) {
-            auto &&deallocate_func = res.value();
-            deallocate_func(plugin.interface);
-        } else
-            elog("Failed to load plugin {} deallocator, reason: {}",
-                 plugin.interface->name(),
-                 res.error().message());
+        // joins the workers before the plugin goes away
+        plugin->executor.reset();
+        plugin->instance.store(nullptr);
     }
 
+    m_metrics_server.reset();
+    // flushes the buffered requests, they are sent before the scheduler stops
+    m_outbound.reset();
+
+    const auto deadline = std::chrono::steady_clock::now() + DRAIN_TIMEOUT;
+    while (m_scheduler.pending() > 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(10ms);
+
+    m_scheduler.stop();
+
+    // dpp releases the callbacks it still holds, they are made of plugin code
+    m_shards.clear();
+    m_bot.reset();
+
+    reapRetiredPlugins();
+
+    m_downloader.reset();
     curl_global_cleanup();
 }
 
@@ -156,129 +504,1431 @@ Inquisitor::~Inquisitor() {
 /////////////////////////////////////
 auto Inquisitor::run([[maybe_unused]] const core::Int32 argc, [[maybe_unused]] const char **argv)
     -> core::Int32 {
-    m_bot->start(false);
+    m_connect_started_at = StartupReport::Clock::now();
+
+    const auto sessions = m_session_store ? m_session_store->load() : std::nullopt;
+    if (sessions) {
+        m_bot->me.id       = sessions->user_id;
+        m_bot->me.username = sessions->username;
+
+        {
+            auto lock  = std::unique_lock { m_sessions_mutex };
+            m_sessions = *sessions;
+        }
+
+        // a resume gets no READY, and the missed events are replayed before RESUMED
+        std::call_once(m_initialized, [this] { initializeBot(std::nullopt); });
+    }
+
+    connect(sessions);
+
+    if (m_session_store)
+        m_bot->start_timer([this](auto) { saveSessions(); }, SESSION_SAVE_INTERVAL);
+
+    m_run.wait(true);
+
+    ilog("Stopping, draining the plugins work");
+    drain();
+    if (m_session_store) saveSessions();
 
     return EXIT_SUCCESS;
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto Inquisitor::parseSettings() -> void {
-    ilog("Loading settings.json");
+auto Inquisitor::stop() noexcept -> void {
+    m_run = false;
+    m_run.notify_all();
+}
 
-    auto file = std::ifstream {};
-    file.open("settings.json");
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::messageScanner() noexcept -> MessageScanner & {
+    return m_message_scanner;
+}
 
-    const auto string =
-        std::string { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::resumer() -> Resumer {
+    auto executor = Executor::current();
+    if (!executor) return [](auto handle) { handle.resume(); };
+
+    return [executor,
+            trace_id = Tracer::current(),
+            parent   = Tracer::currentSlice(),
+            instance = t_instance](auto handle) {
+        executor->postContinuation([handle, trace_id, parent, instance] {
+            const auto context = Tracer::Context { trace_id, parent };
+            const auto owner   = InstanceContext { instance };
+
+            handle.resume();
+        });
+    };
+}
 
-    auto document = json::parse(string);
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::sendRequest(std::string_view name,
+                             Priority priority,
+                             Request request,
+                             Completion on_completion,
+                             dpp::snowflake major) -> void {
+    // dpp may hold the callbacks, made of plugin code, after the handler completed. The sending
+    // instance, and so its library, stays alive until they are destroyed. Requests of the core
+    // pin nothing
+    auto pin = std::shared_ptr<void> { t_instance };
+    request  = Pinned<Request> { pin, std::move(request) };
+    on_completion = Pinned<Completion> { std::move(pin), std::move(on_completion) };
+
+    if (const auto trace_id = Tracer::current(); trace_id != 0) {
+        auto slice = std::make_shared<Tracer::Slice>(
+            m_tracer->slice(trace_id, Tracer::currentSlice(), "rest", name));
+
+        on_completion = [slice = std::move(slice),
+                         on_completion = std::move(on_completion)](const auto &result) mutable {
+            *slice = {};
+            on_completion(result);
+        };
+    }
 
-    m_token = document["token"].get<std::string>();
+    if (m_mode == Mode::REPLAY) {
+        auto http  = dpp::http_request_completion_t {};
+        auto value = replayResult(name);
+        if (value)
+            http.status = 200;
+        else {
+            const auto error = std::format("{} is unavailable in replay mode", name);
 
-    auto enabled_plugins = document["enabled_plugins"].get<std::vector<std::string>>();
-    for (auto &enabled_plugin : enabled_plugins) {
-        m_enabled_plugins.emplace_back(enabled_plugin);
+            http.status = 501;
+            http.body   = json { { "code", 0 }, { "message", error }, { "errors", json::object() } }
+                            .dump();
+        }
 
-        auto options = json {};
+        on_completion(dpp::confirmation_callback_t { m_bot.get(),
+                                                     value.value_or(dpp::confirmation {}),
+                                                     http });
 
-        if (document.contains(enabled_plugin)) options = document[enabled_plugin];
+        return;
+    }
+
+    m_scheduler.submit(std::string { name },
+                       major,
+                       priority,
+                       std::move(request),
+                       std::move(on_completion));
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::cachedMessage(dpp::snowflake id) -> std::shared_ptr<const dpp::message> {
+    return m_message_cache->find(id);
+}
 
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::cacheMessage(const dpp::message &message) -> void {
+    m_message_cache->insert(message);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::reply(const dpp::interaction_create_t &event, dpp::message message) -> void {
+    sendRequest(
+        "interaction_response",
+        Priority::INTERACTION,
+        [event, message = std::move(message)](auto callback) {
+            event.reply(dpp::ir_channel_message_with_source, message, std::move(callback));
+        },
+        [](const auto &result) {
+            if (result.is_error())
+                elog("Failed to reply to an interaction, reason: {}", result.get_error().message);
+        },
+        event.command.id);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::deleteMessage(dpp::snowflake id, dpp::snowflake channel_id) -> void {
+    m_outbound->deleteMessage(id, channel_id);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::addReaction(const dpp::message &message, std::string_view emoji) -> void {
+    m_outbound->addReaction(message.id, message.channel_id, emoji);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::download(DownloadRequest request) -> std::future<DownloadResult> {
+    return m_downloader->download(std::move(request));
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::replay(const std::filesystem::path &path) -> std::size_t {
+    std::call_once(m_initialized, [this] { initializeBot(std::nullopt); });
+
+    for (auto initializing = m_initializing.load(); initializing != 0;
+         initializing      = m_initializing.load())
+        m_initializing.wait(initializing);
+
+    // 0 lets discord pick the shard count, the replay assumes one shard per cluster then
+    const auto settings  = m_settings.get();
+    const auto &sharding = settings->sharding;
+    const auto shards    = std::max(sharding.shards, sharding.clusters);
+
+    // the events the gateway would send to this cluster, direct messages go through shard 0
+    const auto owned = [&](const json &data) {
+        auto guild_id = core::UInt64 { 0 };
+        if (data.contains("guild_id") && data["guild_id"].is_string())
+            guild_id = std::stoull(data["guild_id"].get<std::string>());
+
+        return ((guild_id >> 22) % shards) % sharding.clusters == m_cluster_id;
+    };
+
+    auto reader = EventLogReader { path };
+    auto count  = std::size_t { 0 };
+
+    while (auto payload = reader.next()) {
+        auto document = json::parse(*payload, nullptr, false);
+        if (document.is_discarded() || !document.contains("t") || !document["t"].is_string())
+            continue;
+
+        const auto type = document["t"].get<std::string>();
+        auto &data      = document["d"];
+
+        if (type != "READY" && !owned(data)) continue;
+
+        if (type == "READY") {
+            m_bot->me.fill_from_json(&data["user"]);
+
+            auto event       = dpp::ready_t { nullptr, *payload };
+            event.session_id = data.value("session_id", "");
+
+            m_bot->on_ready.call(event);
+        } else if (type == "MESSAGE_CREATE") {
+            auto message = dpp::message { m_bot.get() };
+            message.fill_from_json(&data);
+
+            auto event = dpp::message_create_t { nullptr, *payload };
+            event.msg  = &message;
+
+            m_bot->on_message_create.call(event);
+        } else if (type == "INTERACTION_CREATE") {
+            auto event = dpp::interaction_create_t { nullptr, *payload };
+            event.command.fill_from_json(&data);
+
+            m_bot->on_interaction_create.call(event);
+        } else
+            continue;
+
+        ++count;
+    }
+
+    return count;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::accept(const dpp::event_dispatch_t &event) -> bool {
+    if (!m_run) return false;
+
+    // dpp dispatches from the shard thread right after reading the sequence of the event
+    if (event.from) {
+        auto lock     = std::unique_lock { m_sessions_mutex };
+        const auto it = m_sessions.shards.find(event.from->shard_id);
+        if (it != std::ranges::end(m_sessions.shards)) it->second.sequence = event.from->last_seq;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::drain() -> void {
+    const auto deadline = std::chrono::steady_clock::now() + DRAIN_TIMEOUT;
+
+    // handlers waiting for a response are resumed on their executor once it comes, which may
+    // queue more requests
+    for (;;) {
+        m_outbound->flush();
+        waitIdle();
+
+        const auto pending = m_scheduler.pending();
+        if (pending == 0) break;
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            wlog("Stopping with {} requests still pending", pending);
+            break;
+        }
+
+        std::this_thread::sleep_for(10ms);
+    }
+
+    waitIdle();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::connect(const std::optional<SessionStore::State> &sessions) -> void {
+    const auto snapshot  = m_settings.get();
+    const auto &settings = *snapshot;
+
+    auto promise = std::promise<dpp::confirmation_callback_t> {};
+    m_bot->get_gateway_bot([&promise](const auto &callback) { promise.set_value(callback); });
+
+    const auto callback = promise.get_future().get();
+    if (callback.is_error())
+        throw std::runtime_error { std::format("Failed to query the gateway, {}",
+                                               callback.get_error().message) };
+
+    const auto gateway     = std::get<dpp::gateway>(callback.value);
+    const auto shards      = (settings.sharding.shards != 0) ? settings.sharding.shards
+                                                              : gateway.shards;
+    const auto concurrency = std::max(gateway.session_start_max_concurrency, 1u);
+
+    const auto saved_session = [&](core::UInt32 id) -> const SessionStore::Shard * {
+        if (!sessions) return nullptr;
+
+        const auto it = sessions->shards.find(id);
+        return (it != std::ranges::end(sessions->shards)) ? &it->second : nullptr;
+    };
+
+    // dpp::cluster::start() creates and runs its shards at once, a session set afterward races
+    // with the shard thread reading it on HELLO. dpp sends RESUME instead of IDENTIFY for a
+    // shard which has one, and identifies by itself when the gateway refuses it
+    auto resumed     = 0u;
+    auto identifying = 0u;
+    for (auto id = m_cluster_id; id < shards; id += settings.sharding.clusters) {
+        const auto *saved = saved_session(id);
+
+        if (!saved) {
+            if (identifying > 0 && identifying % concurrency == 0)
+                std::this_thread::sleep_for(IDENTIFY_INTERVAL);
+            ++identifying;
+        }
+
+        auto shard = std::make_unique<dpp::discord_client>(m_bot.get(),
+                                                           id,
+                                                           shards,
+                                                           settings.token,
+                                                           m_intents,
+                                                           settings.gateway.compression);
+        if (saved) {
+            shard->sessionid = saved->session_id;
+            shard->last_seq  = saved->sequence;
+
+            ++resumed;
+        }
+
+        shard->run();
+        m_shards.emplace(id, std::move(shard));
+    }
+
+    ilog("Started {} shards, {} resuming their session", std::size(m_shards), resumed);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::saveSessions() -> void {
+    // keeps the timer and stop() from writing the file at the same time
+    auto save_lock = std::unique_lock { m_save_mutex };
+
+    auto state = [this] {
+        auto lock = std::unique_lock { m_sessions_mutex };
+        return m_sessions;
+    }();
+    if (std::empty(state.shards)) return;
+
+    state.saved_at = SessionStore::Clock::now();
+    m_session_store->save(state);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::waitIdle() -> void {
+    for (auto &plugin : m_plugins) plugin->executor->waitIdle();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::executors() const -> std::vector<const Executor *> {
+    auto executors = std::vector<const Executor *> {};
+    executors.reserve(std::size(m_plugins));
+
+    for (const auto &plugin : m_plugins) executors.emplace_back(plugin->executor.get());
+
+    return executors;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::parseSettings() const -> Settings {
+    ilog("Loading {}", Settings::PATH);
+
+    auto settings = Settings::load();
+
+    for (auto &[_, options] : settings.plugin_options)
         options["inquisitor"] = json::parse(
             std::format(R"({{ "major": {}, "minor": {} }})", MAJOR_VERSION, MINOR_VERSION));
 
-        m_plugin_options.emplace(enabled_plugin, std::move(options));
+    return settings;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::validatePluginOptions(const Settings &settings, const Settings *previous) const
+    -> bool {
+    auto valid = true;
+
+    for (const auto &plugin : m_plugins) {
+        const auto it = settings.plugin_options.find(plugin->name);
+        if (it == std::ranges::cend(settings.plugin_options)) continue;
+
+        // an entry missing from the previous settings is validated like a changed one
+        if (previous) {
+            const auto old = previous->plugin_options.find(plugin->name);
+            if (old != std::ranges::cend(previous->plugin_options) && old->second == it->second)
+                continue;
+        }
+
+        try {
+            plugin->instance.load()->validateOptions(it->second);
+        } catch (const InvalidOptions &e) {
+            elog("{} {}", plugin->name, e.what());
+            valid = false;
+        }
     }
+
+    return valid;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::reloadSettings() -> bool {
+    auto settings = Settings {};
+
+    try {
+        settings = parseSettings();
+    } catch (const std::exception &e) {
+        elog("Keeping the current settings, {} is invalid: {}", Settings::PATH, e.what());
+        return false;
+    }
+
+    auto lock = std::unique_lock { m_reload_mutex };
+
+    const auto old_settings = m_settings.get();
+    if (!validatePluginOptions(settings, old_settings.get())) {
+        elog("Keeping the current settings, {} has invalid plugin options", Settings::PATH);
+        return false;
+    }
+
+    const auto new_settings = m_settings.publish(std::move(settings));
+    const auto &old         = *old_settings;
+    const auto &current     = *new_settings;
+
+    if (current.token != old.token || current.enabled_plugins != old.enabled_plugins)
+        wlog("token and enabled_plugins changes are only applied on restart");
+
+    auto changed = false;
+    for (auto &plugin : m_plugins) {
+        const auto it = current.plugin_options.find(plugin->name);
+        if (it == std::ranges::cend(current.plugin_options)) continue;
+
+        // an entry missing from the previous settings counts as changed
+        const auto previous     = old.plugin_options.find(plugin->name);
+        const auto &old_options = (previous != std::ranges::cend(old.plugin_options))
+                                      ? previous->second
+                                      : NO_OPTIONS;
+        const auto &new_options = it->second;
+        if (previous != std::ranges::cend(old.plugin_options) && old_options == new_options)
+            continue;
+
+        // initialize() reads the options once the plugin gets initialized
+        if (!plugin->initialized) continue;
+
+        changed = true;
+
+        // no other callback of the plugin runs meanwhile, whatever its executor threads count
+        auto done = std::promise<void> {};
+        plugin->executor->postExclusive([&] {
+            try {
+                const auto instance = plugin->instance.load();
+                const auto owner    = InstanceContext { instance };
+
+                instance->applyOptions(new_options);
+                instance->onConfigChanged(old_options, new_options);
+            } catch (const std::exception &e) {
+                elog("{} failed to apply its new options, reason: {}", plugin->name, e.what());
+            }
+
+            done.set_value();
+        });
+        done.get_future().wait();
+    }
+
+    // subscriptions and commands may depend on the options
+    if (changed) rebuildDispatch();
+
+    m_tracer->configure(current.tracing.enabled, current.tracing.sample_every);
+
+    ilog("{} reloaded", Settings::PATH);
+
+    return true;
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
 auto Inquisitor::loadPlugins() -> void {
+    struct Candidate {
+        std::string name;
+        std::filesystem::path path;
+    };
+
+    const auto snapshot  = m_settings.get();
+    const auto &settings = *snapshot;
+
+    auto candidates = std::vector<Candidate> {};
+
     for (auto &plugin : std::filesystem::recursive_directory_iterator("plugins")) {
         const auto plugin_path = plugin.path();
 
-        if (plugin_path.extension() == ".so" || plugin_path.extension() == ".dll") {
-            ilog("{} found", plugin_path.string());
-            loadPlugin(plugin_path);
+        if (plugin_path.extension() != ".so" && plugin_path.extension() != ".dll") continue;
+
+        auto name = probePluginName(plugin_path);
+        if (!name) continue;
+
+        if (std::ranges::find(settings.enabled_plugins, *name) ==
+            std::ranges::cend(settings.enabled_plugins)) {
+            dlog("{} found but not enabled, skipping", plugin_path.string());
+            continue;
+        }
+
+        if (std::ranges::any_of(candidates, [&](const auto &c) { return c.name == *name; })) {
+            wlog("{} found twice, ignoring {}", *name, plugin_path.string());
+            continue;
         }
+
+        ilog("{} found", plugin_path.string());
+        candidates.emplace_back(Candidate { std::move(*name), plugin_path });
+    }
+
+    for (const auto &name : settings.enabled_plugins) {
+        if (std::ranges::none_of(candidates, [&](const auto &c) { return c.name == name; }))
+            wlog("{} is enabled but wasn't found", name);
+    }
+
+    // loads the libraries in parallel, the heavy setup is deferred to prepare()
+    auto loading = std::vector<std::future<std::unique_ptr<Plugin>>> {};
+    loading.reserve(std::size(candidates));
+
+    for (const auto &candidate : candidates)
+        loading.emplace_back(std::async(std::launch::async, [this, &candidate] {
+            const auto start = StartupReport::Clock::now();
+            auto plugin      = loadPlugin(candidate.name, candidate.path);
+            m_startup.record("load", candidate.name, start);
+
+            return plugin;
+        }));
+
+    for (auto &future : loading) {
+        auto plugin = future.get();
+        if (plugin) m_plugins.emplace_back(std::move(plugin));
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::loadPlugin(const std::string &name, const std::filesystem::path &path)
+    -> std::unique_ptr<Plugin> {
+    auto instance = instantiate(name, path);
+    if (!instance) return nullptr;
+
+    ilog("{} loaded", name);
+
+    const auto settings = m_settings.get();
+    const auto &options = settings->plugin_options.at(name);
+
+    auto plugin      = std::make_unique<Plugin>();
+    plugin->name     = name;
+    plugin->path     = path;
+    plugin->executor = std::make_unique<Executor>(
+        name,
+        Executor::parseSettings(options.contains("executor") ? options["executor"] : json {}));
+    plugin->instance.store(std::move(instance));
+
+    return plugin;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::preparePlugins() -> void {
+    // overlaps the gateway connection, initialize() waits for it
+    for (auto &plugin : m_plugins) {
+        plugin->executor->postContinuation([this, &plugin = *plugin] {
+            const auto start = StartupReport::Clock::now();
+
+            try {
+                const auto instance = plugin.instance.load();
+                const auto owner    = InstanceContext { instance };
+                instance->prepare();
+            } catch (const std::exception &e) {
+                elog("{} failed to prepare, reason: {}", plugin.name, e.what());
+                plugin.failed = true;
+            }
+
+            m_startup.record("prepare", plugin.name, start);
+
+            plugin.prepared = true;
+            plugin.prepared.notify_all();
+        });
     }
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto Inquisitor::loadPlugin(const std::filesystem::path &path) -> void {
+auto Inquisitor::instantiate(const std::string &name, const std::filesystem::path &path)
+    -> Instance {
     auto res = core::DynamicLoader::load(path);
     if (!res) {
         elog("Failed to load plugin {}", res.error().message());
-        return;
+        return nullptr;
     }
 
-    auto &&loader = res.value();
-    auto res2     = loader.func<PluginInterface *()>("allocatePlugin");
+    auto loader = std::make_shared<core::DynamicLoader>(std::move(res.value()));
+
+    auto res2 = loader->func<PluginInterface *()>("allocatePlugin");
     if (!res2) {
-        elog("Failed to initialize plugin {}", res.error().message());
-        return;
+        elog("Failed to initialize plugin {}", res2.error().message());
+        return nullptr;
+    }
+
+    auto res3 = loader->func<void(PluginInterface *)>("deallocatePlugin");
+    if (!res3) {
+        elog("Failed to load plugin {} deallocator, reason: {}", name, res3.error().message());
+        return nullptr;
     }
 
     auto &&allocate_func  = res2.value();
     auto plugin_interface = allocate_func();
 
-    const auto plugin_name = plugin_interface->name();
+    if (plugin_interface->name() != name)
+        wlog("{} reports the name {}, its pluginName() export is out of date",
+             name,
+             plugin_interface->name());
+
+    // the last reference may be dropped from inside the plugin code (a coroutine frame), so the
+    // library is only closed later by reapRetiredPlugins()
+    return Instance { plugin_interface,
+                      [this,
+                       retired = Retired { name, std::move(loader), std::move(res3.value()), nullptr }](
+                          auto *released) mutable {
+                          retired.interface = released;
+                          retire(std::move(retired));
+                      } };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::retire(Retired retired) -> void {
+    auto lock = std::unique_lock { m_retired_mutex };
 
-    if (std::ranges::find(m_enabled_plugins, plugin_interface->name()) ==
-        std::ranges::cend(m_enabled_plugins))
-        return;
+    m_retired.emplace_back(std::move(retired));
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::reapRetiredPlugins() -> void {
+    auto retired = [this] {
+        auto lock = std::unique_lock { m_retired_mutex };
+
+        return std::exchange(m_retired, {});
+    }();
+
+    // the requests of an instance pin it, none is in flight anymore
+    for (auto &plugin : retired) {
+        dlog("Unloading {}", plugin.interface->name());
+        plugin.deallocate(plugin.interface);
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::reloadPlugin(std::string_view name) -> bool {
+    const auto it =
+        std::ranges::find_if(m_plugins, [&](const auto &plugin) { return plugin->name == name; });
+    if (it == std::ranges::cend(m_plugins)) {
+        wlog("Can't reload {}, it isn't loaded", name);
+        return false;
+    }
+
+    auto &plugin = **it;
+
+    auto lock = std::unique_lock { m_reload_mutex };
+
+    ilog("Reloading {}", plugin.name);
+
+    // dlopen hands back the already mapped library for a path it knows, load a private copy
+    const auto copy = std::filesystem::temp_directory_path() /
+                      std::format("inquisitor-{}-{}{}",
+                                  plugin.name,
+                                  ++m_reload_count,
+                                  plugin.path.extension().string());
+
+    auto error = std::error_code {};
+    std::filesystem::copy_file(plugin.path,
+                               copy,
+                               std::filesystem::copy_options::overwrite_existing,
+                               error);
+    if (error) {
+        elog("Failed to reload {}, reason: {}", plugin.name, error.message());
+        return false;
+    }
+
+    auto instance = instantiate(plugin.name, copy);
+    std::filesystem::remove(copy, error);
+
+    if (!instance) return false;
+
+    const auto owner = InstanceContext { instance };
+
+    try {
+        instance->prepare();
+    } catch (const std::exception &e) {
+        elog("Failed to prepare reloaded {}, reason: {}", plugin.name, e.what());
+        return false;
+    }
 
-    ilog("{} loaded", plugin_name);
+    if (const auto missing = instance->intents() & ~m_intents; missing != 0)
+        wlog("{} needs the gateway intents {:#x}, they are only requested on restart",
+             plugin.name,
+             missing);
+
+    auto others = std::vector<const PluginInterface *> {};
+    for (const auto &other : m_plugins)
+        others.emplace_back((other.get() == &plugin) ? instance.get()
+                                                     : other->instance.load().get());
+
+    try {
+        initializeInstance(plugin, *instance, std::move(others));
+    } catch (const std::exception &e) {
+        elog("Failed to initialize reloaded {}, reason: {}", plugin.name, e.what());
+        return false;
+    }
+
+    plugin.instance.store(std::move(instance));
+    plugin.failed      = false;
+    plugin.initialized = true;
+
+    rebuildDispatch();
+
+    ilog("{} reloaded", plugin.name);
 
-    m_plugins.emplace_back(Plugin { std::move(path), std::move(loader), plugin_interface });
+    return true;
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto Inquisitor::initializeBot() -> void {
-    struct Commands {
-        PluginInterface *plugin;
-        std::vector<PluginInterface::Command> commands;
+auto Inquisitor::watchPlugins(std::stop_token token) -> void {
+    const auto processRequests = [this] {
+        auto requests = [this] {
+            auto lock = std::unique_lock { m_reload_requests_mutex };
+
+            return std::exchange(m_reload_requests, {});
+        }();
+
+        for (auto &request : requests) request.on_done(request.reload());
     };
 
-    auto plugins = std::vector<Commands> {};
+#if defined(__linux__)
+    const auto fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) elog("Failed to watch plugins directory, reason: {}", std::strerror(errno));
 
-    auto _plugins = std::vector<const PluginInterface *> {};
-    for (const auto &plugin : m_plugins) _plugins.emplace_back(plugin.interface);
+    auto directories = core::HashMap<int, std::filesystem::path> {};
+    const auto watch = [&](const std::filesystem::path &directory) {
+        const auto wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd >= 0) directories.emplace(wd, directory);
+    };
 
-    for (auto &plugin : m_plugins) {
-        plugin.interface->initialize(m_plugin_options.at(std::string { plugin.interface->name() }),
-                                     _plugins);
-
-        if (!std::empty(plugin.interface->commands())) {
-            auto plugin_command     = Commands {};
-            plugin_command.plugin   = plugin.interface;
-            plugin_command.commands = plugin.interface->commands();
-            for (auto command_ : plugin.interface->commands()) {
-                auto command = dpp::slashcommand {}
-                                   .set_name(std::string { command_.name })
-                                   .set_description(std::string { command_.description })
-                                   .set_application_id(m_bot->me.id)
-                                   .set_type(dpp::ctxm_chat_input);
-
-                m_bot->global_command_create(command);
+    if (fd >= 0) {
+        watch("plugins");
+        for (const auto &entry : std::filesystem::recursive_directory_iterator("plugins"))
+            if (entry.is_directory()) watch(entry.path());
+    }
+
+    // editors usually save by renaming, so the directory is watched rather than the file
+    const auto settings_path = std::filesystem::path { "." } / Settings::PATH;
+    if (fd >= 0) watch(settings_path.parent_path());
+
+    alignas(inotify_event) char buffer[4096];
+
+    while (!token.stop_requested()) {
+        processRequests();
+
+        auto poll_fd = pollfd { fd, POLLIN, 0 };
+        if (fd < 0 || ::poll(&poll_fd, 1, WATCH_POLL_TIMEOUT) <= 0) {
+            if (fd < 0) std::this_thread::sleep_for(std::chrono::milliseconds { WATCH_POLL_TIMEOUT });
+            continue;
+        }
+
+        const auto size = ::read(fd, buffer, sizeof(buffer));
+
+        for (auto offset = ssize_t { 0 }; offset < size;) {
+            const auto &event = *reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += sizeof(inotify_event) + event.len;
+
+            const auto directory = directories.find(event.wd);
+            if (event.len == 0 || directory == std::ranges::cend(directories)) continue;
+
+            const auto path = directory->second / event.name;
+            if (path == settings_path) {
+                reloadSettings();
+                continue;
             }
-            plugins.emplace_back(std::move(plugin_command));
+
+            for (const auto &plugin : m_plugins)
+                if (plugin->path == path) reloadPlugin(plugin->name);
         }
     }
 
-    m_bot->on_interaction_create([this, plugins = std::move(plugins)](const auto &event) {
-        auto cmd_data = std::get<dpp::command_interaction>(event.command.data);
+    if (fd >= 0) ::close(fd);
+#else
+    wlog("Plugin directory watching is only supported on linux, use the /{} and /{} commands",
+         RELOAD_COMMAND,
+         RELOAD_SETTINGS_COMMAND);
+
+    while (!token.stop_requested()) {
+        processRequests();
+        std::this_thread::sleep_for(std::chrono::milliseconds { WATCH_POLL_TIMEOUT });
+    }
+#endif
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::registerCommands(std::vector<CommandRouter::Route> routes,
+                                  std::vector<dpp::slashcommand> commands) -> void {
+    const auto application_id = m_bot->me.id;
+    const auto fingerprint    = CommandState::fingerprintOf(commands);
+
+    // the routes only change with the commands
+    if (fingerprint == m_registered_fingerprint) return;
+    m_registered_fingerprint = fingerprint;
+
+    // route by name until the command ids are known
+    m_command_router.publish(CommandRouter { routes });
+
+    if (auto state = CommandState::load();
+        state && state->application_id == application_id && state->fingerprint == fingerprint) {
+        ilog("Slash commands unchanged since last run, skipping registration");
+        publishCommandIds(std::move(routes), *state);
 
-        for (auto &plugin : plugins)
-            for (auto &command : plugin.commands)
-                if (cmd_data.name == command.name) plugin.plugin->onCommand(event, *m_bot);
+        return;
+    }
+
+    // commands are global, only the first cluster registers them, the others route by name
+    if (m_cluster_id != 0 || m_mode == Mode::REPLAY) {
+        commandsReady();
+        return;
+    }
+
+    m_bot->global_commands_get([this, routes, commands, application_id, fingerprint](
+                                   const auto &event) mutable {
+        if (event.is_error())
+            elog("Failed to fetch registered slash commands, reason: {}",
+                 event.get_error().message);
+        else {
+            auto state = CommandState::fromCommands(
+                application_id,
+                toVector(std::get<dpp::slashcommand_map>(event.value)));
+
+            if (state.fingerprint == fingerprint) {
+                ilog("Slash commands already registered");
+                state.save();
+                publishCommandIds(std::move(routes), state);
+
+                return;
+            }
+        }
+
+        ilog("Registering {} slash commands", std::size(commands));
+        m_bot->global_bulk_command_create(
+            commands,
+            [this, routes, application_id, fingerprint](const auto &event) mutable {
+                if (event.is_error()) {
+                    elog("Failed to register slash commands, reason: {}",
+                         event.get_error().message);
+
+                    // the next rebuildDispatch() retries
+                    {
+                        auto lock = std::unique_lock { m_reload_mutex };
+                        if (m_registered_fingerprint == fingerprint)
+                            m_registered_fingerprint.clear();
+                    }
+
+                    commandsReady();
+                    return;
+                }
+
+                auto state = CommandState::fromCommands(
+                    application_id,
+                    toVector(std::get<dpp::slashcommand_map>(event.value)));
+
+                state.save();
+                publishCommandIds(std::move(routes), state);
+            });
+    });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::publishCommandIds(std::vector<CommandRouter::Route> routes,
+                                   const CommandState &state) -> void {
+    for (auto &route : routes) {
+        const auto it = state.ids.find(route.name);
+        if (it != std::ranges::cend(state.ids)) route.id = it->second;
+    }
+
+    m_command_router.publish(CommandRouter { std::move(routes) });
+
+    commandsReady();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::commandsReady() -> void {
+    if (m_commands_ready.exchange(true)) return;
+
+    m_startup.record("commands", "", m_commands_started_at, true);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::logExecutorStats() const -> void {
+    for (const auto &plugin : m_plugins) {
+        const auto stats = plugin->executor->stats();
+
+        if (stats.depth == 0 && stats.executed == 0 && stats.dropped == 0) continue;
+
+        ilog("{}: {} queued, {} executed, {} dropped, wait avg {}us max {}us",
+             plugin->executor->name(),
+             stats.depth,
+             stats.executed,
+             stats.dropped,
+             stats.average_wait.count(),
+             stats.max_wait.count());
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::logRequestStats() const -> void {
+    const auto stats = m_scheduler.stats();
+
+    for (auto i = 0u; i < std::size(stats); ++i)
+        dlog("outbound {}: {} queued, {} sent, wait avg {}us max {}us",
+             RequestScheduler::className(static_cast<Priority>(i)),
+             stats[i].depth,
+             stats[i].sent,
+             stats[i].average_wait.count(),
+             stats[i].max_wait.count());
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::logMessageCacheStats() const -> void {
+    const auto stats   = m_message_cache->stats();
+    const auto lookups = stats.hits + stats.misses;
+
+    dlog("message cache: {} messages, {} bytes, {} hits, {} misses ({:.1f}% hit rate)",
+         stats.entries,
+         stats.bytes,
+         stats.hits,
+         stats.misses,
+         (lookups > 0) ? 100. * static_cast<double>(stats.hits) / static_cast<double>(lookups)
+                       : 0.);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::logDownloadStats() const -> void {
+    const auto stats = m_downloader->stats();
+
+    dlog("downloads: {} completed, {} failed, {} bytes, {} connections opened, {} running, {} "
+         "queued",
+         stats.completed,
+         stats.failed,
+         stats.bytes,
+         stats.connections,
+         stats.running,
+         stats.queued);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::cachePolicy(const Settings::Cache &cache) const -> dpp::cache_policy_t {
+    using Caches = PluginInterface::Caches;
+    using Policy = Settings::Cache::Policy;
+
+    auto needed = core::UInt8 { Caches::NONE };
+    for (const auto &plugin : m_plugins) needed |= plugin->instance.load()->caches();
+
+    auto summary      = std::string {};
+    const auto policy = [&](std::string_view entity,
+                            std::optional<Policy> configured,
+                            core::UInt8 flag) {
+        const auto policy = configured.value_or((needed & flag) ? Policy::LAZY : Policy::NONE);
+
+        constexpr auto NAMES = std::array { "none", "lazy", "aggressive" };
+        summary += std::format("{}{} {}",
+                               std::empty(summary) ? "" : ", ",
+                               entity,
+                               NAMES[static_cast<std::size_t>(policy)]);
+
+        switch (policy) {
+            case Policy::LAZY: return dpp::cp_lazy;
+            case Policy::AGGRESSIVE: return dpp::cp_aggressive;
+            default: return dpp::cp_none;
+        }
+    };
+
+    auto result         = dpp::cache_policy_t {};
+    result.user_policy  = policy("users", cache.users, Caches::USERS);
+    result.role_policy  = policy("roles", cache.roles, Caches::ROLES);
+    result.emoji_policy = policy("emojis", cache.emojis, Caches::EMOJIS);
+
+    // dpp 9 has no policy for them, the budget trims their members instead
+    ilog("dpp cache policies: {}, guilds and channels always cached", summary);
+
+    return result;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::logCacheStats() const -> void {
+    static constexpr auto LOGGED_GUILDS = 10u;
+
+    const auto report = m_cache_budget->report();
+
+    dlog("dpp cache: {} bytes, {} guilds, {} users ({} bytes), {} members trimmed",
+         report.bytes,
+         std::size(report.guilds),
+         report.users,
+         report.user_bytes,
+         m_cache_budget->trimmedMembers());
+
+    for (const auto &guild : report.guilds | std::views::take(LOGGED_GUILDS))
+        dlog("dpp cache guild {}: {} bytes, {} members, {} channels, {} roles, {} emojis",
+             static_cast<std::uint64_t>(guild.id),
+             guild.bytes,
+             guild.members,
+             guild.channels,
+             guild.roles,
+             guild.emojis);
+
+    if (const auto trimmed = m_cache_budget->plan(report); trimmed > 0)
+        wlog("dpp cache uses {} bytes, over its {} bytes budget, dropping the members of {} "
+             "guilds",
+             report.bytes,
+             m_cache_budget->budget(),
+             trimmed);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::logGatewayStats() const -> void {
+    if (!m_gateway_stats) return;
+
+    for (const auto &entry : m_gateway_stats->entries())
+        ilog("gateway {}: {} events, {} bytes, decode {}us ({:.2f}us/event)",
+             entry.type,
+             entry.count,
+             entry.bytes,
+             entry.decode.count(),
+             static_cast<double>(entry.decode.count()) / static_cast<double>(entry.count));
+
+    for (const auto &[id, shard] : m_shards)
+        ilog("gateway shard {}: {} bytes received, {} bytes decompressed",
+             id,
+             shard->get_bytes_in(),
+             shard->get_decompressed_bytes_in());
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::measureGateway() -> void {
+    m_gateway_stats = std::make_unique<GatewayStats>();
+
+    // additional listeners, the dispatch handlers are left untouched. Events without a listener
+    // are still decoded by dpp but aren't accounted
+    const auto measure = [this](auto &router, std::string_view type) {
+        router([this, type](const auto &event) { m_gateway_stats->record(type, event.raw_event); });
+    };
+
+    measure(m_bot->on_ready, "READY");
+    measure(m_bot->on_resumed, "RESUMED");
+    measure(m_bot->on_guild_create, "GUILD_CREATE");
+    measure(m_bot->on_guild_update, "GUILD_UPDATE");
+    measure(m_bot->on_guild_delete, "GUILD_DELETE");
+    measure(m_bot->on_channel_create, "CHANNEL_CREATE");
+    measure(m_bot->on_channel_update, "CHANNEL_UPDATE");
+    measure(m_bot->on_thread_create, "THREAD_CREATE");
+    measure(m_bot->on_thread_update, "THREAD_UPDATE");
+    measure(m_bot->on_guild_member_add, "GUILD_MEMBER_ADD");
+    measure(m_bot->on_guild_member_update, "GUILD_MEMBER_UPDATE");
+    measure(m_bot->on_presence_update, "PRESENCE_UPDATE");
+    measure(m_bot->on_typing_start, "TYPING_START");
+    measure(m_bot->on_voice_state_update, "VOICE_STATE_UPDATE");
+    measure(m_bot->on_message_create, "MESSAGE_CREATE");
+    measure(m_bot->on_message_update, "MESSAGE_UPDATE");
+    measure(m_bot->on_message_delete, "MESSAGE_DELETE");
+    measure(m_bot->on_message_delete_bulk, "MESSAGE_DELETE_BULK");
+    measure(m_bot->on_message_reaction_add, "MESSAGE_REACTION_ADD");
+    measure(m_bot->on_message_reaction_remove, "MESSAGE_REACTION_REMOVE");
+    measure(m_bot->on_interaction_create, "INTERACTION_CREATE");
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::onTraceCommand(const dpp::interaction_create_t &event) -> void {
+    const auto action = std::get<std::string>(event.get_parameter("action"));
+
+    if (action == "start") {
+        const auto sample_every = event.get_parameter("sample_every");
+        const auto *every       = std::get_if<std::int64_t>(&sample_every);
+
+        const auto sample = every ? static_cast<core::UInt32>(std::max<std::int64_t>(*every, 1))
+                                  : 1u;
+
+        m_tracer->configure(true, sample);
+        event.reply(dpp::message { "Tracing started" }.set_flags(dpp::m_ephemeral));
+    } else if (action == "stop") {
+        m_tracer->configure(false, 1);
+        event.reply(dpp::message { "Tracing stopped" }.set_flags(dpp::m_ephemeral));
+    } else {
+        const auto path = std::format(
+            "trace-{}.json",
+            std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count());
+
+        // serializing a large buffer would hold the shard thread
+        event.thinking(true);
+        m_tracer->dump(path, [event, path](auto written) {
+            event.edit_response(written ? std::format("Trace written to {}", path)
+                                        : std::string { "Failed to write the trace" });
+        });
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::queueReload(const dpp::interaction_create_t &event,
+                             std::function<bool()> reload,
+                             std::string what) -> void {
+    event.thinking(true);
+
+    auto lock = std::unique_lock { m_reload_requests_mutex };
+    m_reload_requests.emplace_back(
+        ReloadRequest { std::move(reload), [event, what = std::move(what)](auto success) {
+                           event.edit_response(success ? std::format("{} reloaded", what)
+                                                       : std::format("Failed to reload {}", what));
+                       } });
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::logLatencies() const -> void {
+    for (const auto &plugin : m_plugins) {
+        const auto message = plugin->latencies.message.summary();
+        const auto command = plugin->latencies.command.summary();
+        const auto ingest  = plugin->latencies.ingest.summary();
+
+        if (message.count == 0 && command.count == 0) continue;
+
+        ilog("{}: message p50 {}us p99 {}us p999 {}us | command p50 {}us p99 {}us p999 {}us | "
+             "ingest p50 {}us p99 {}us p999 {}us",
+             plugin->name,
+             message.p50,
+             message.p99,
+             message.p999,
+             command.p50,
+             command.p99,
+             command.p999,
+             ingest.p50,
+             ingest.p99,
+             ingest.p999);
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::metricsReport() const -> std::string {
+    auto report = std::string { "# TYPE inquisitor_latency_microseconds summary\n" };
+
+    const auto append = [&](std::string_view plugin,
+                            std::string_view hook,
+                            const LatencyHistogram &histogram) {
+        const auto summary = histogram.summary();
+
+        for (const auto [quantile, value] : { std::pair { "0.5", summary.p50 },
+                                              std::pair { "0.99", summary.p99 },
+                                              std::pair { "0.999", summary.p999 },
+                                              std::pair { "1", summary.max } })
+            report += std::format(
+                "inquisitor_latency_microseconds{{plugin=\"{}\",hook=\"{}\",quantile=\"{}\"}} {}\n",
+                plugin,
+                hook,
+                quantile,
+                value);
+
+        report += std::format(
+            "inquisitor_latency_microseconds_count{{plugin=\"{}\",hook=\"{}\"}} {}\n",
+            plugin,
+            hook,
+            summary.count);
+    };
+
+    for (const auto &plugin : m_plugins) {
+        append(plugin->name, "ready", plugin->latencies.ready);
+        append(plugin->name, "command", plugin->latencies.command);
+        append(plugin->name, "message", plugin->latencies.message);
+        append(plugin->name, "ingest", plugin->latencies.ingest);
+    }
+
+    auto executors = std::vector<std::pair<std::string_view, Executor::Stats>> {};
+    executors.reserve(std::size(m_plugins));
+    for (const auto &plugin : m_plugins)
+        executors.emplace_back(plugin->name, plugin->executor->stats());
+
+    report += "# TYPE inquisitor_executor_queue_depth gauge\n";
+    for (const auto &[plugin, stats] : executors)
+        report += std::format("inquisitor_executor_queue_depth{{plugin=\"{}\"}} {}\n",
+                              plugin,
+                              stats.depth);
+
+    report += "# TYPE inquisitor_executor_dropped_total counter\n";
+    for (const auto &[plugin, stats] : executors)
+        report += std::format("inquisitor_executor_dropped_total{{plugin=\"{}\"}} {}\n",
+                              plugin,
+                              stats.dropped);
+
+    report += "# TYPE inquisitor_executor_wait_microseconds gauge\n";
+    for (const auto &[plugin, stats] : executors) {
+        report += std::format(
+            "inquisitor_executor_wait_microseconds{{plugin=\"{}\",stat=\"avg\"}} {}\n",
+            plugin,
+            stats.average_wait.count());
+        report += std::format(
+            "inquisitor_executor_wait_microseconds{{plugin=\"{}\",stat=\"max\"}} {}\n",
+            plugin,
+            stats.max_wait.count());
+    }
+
+    const auto cache = m_message_cache->stats();
+    report += std::format("# TYPE inquisitor_message_cache_lookups_total counter\n"
+                          "inquisitor_message_cache_lookups_total{{result=\"hit\"}} {}\n"
+                          "inquisitor_message_cache_lookups_total{{result=\"miss\"}} {}\n"
+                          "# TYPE inquisitor_message_cache_bytes gauge\n"
+                          "inquisitor_message_cache_bytes {}\n"
+                          "# TYPE inquisitor_message_cache_entries gauge\n"
+                          "inquisitor_message_cache_entries {}\n",
+                          cache.hits,
+                          cache.misses,
+                          cache.bytes,
+                          cache.entries);
+
+    const auto dpp_cache = m_cache_budget->report();
+    report += "# TYPE inquisitor_dpp_cache_bytes gauge\n";
+    for (const auto &guild : dpp_cache.guilds)
+        report += std::format("inquisitor_dpp_cache_bytes{{guild=\"{}\"}} {}\n",
+                              static_cast<std::uint64_t>(guild.id),
+                              guild.bytes);
+    report += std::format("inquisitor_dpp_cache_bytes{{guild=\"users\"}} {}\n"
+                          "# TYPE inquisitor_dpp_cache_trimmed_members_total counter\n"
+                          "inquisitor_dpp_cache_trimmed_members_total {}\n",
+                          dpp_cache.user_bytes,
+                          m_cache_budget->trimmedMembers());
+
+    const auto stats = m_scheduler.stats();
+    const auto class_name = [](auto i) {
+        return RequestScheduler::className(static_cast<Priority>(i));
+    };
+
+    report += "# TYPE inquisitor_outbound_queue_depth gauge\n";
+    for (auto i = 0u; i < std::size(stats); ++i)
+        report += std::format("inquisitor_outbound_queue_depth{{class=\"{}\"}} {}\n",
+                              class_name(i),
+                              stats[i].depth);
+
+    report += "# TYPE inquisitor_outbound_wait_microseconds gauge\n";
+    for (auto i = 0u; i < std::size(stats); ++i) {
+        report += std::format(
+            "inquisitor_outbound_wait_microseconds{{class=\"{}\",stat=\"avg\"}} {}\n",
+            class_name(i),
+            stats[i].average_wait.count());
+        report += std::format(
+            "inquisitor_outbound_wait_microseconds{{class=\"{}\",stat=\"max\"}} {}\n",
+            class_name(i),
+            stats[i].max_wait.count());
+    }
+
+    return report;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::initializeBot(std::optional<dpp::ready_t> ready) -> void {
+    if (m_mode == Mode::GATEWAY) m_startup.record("gateway", "", m_connect_started_at);
+    m_startup.await(std::size(m_plugins) + 1);
+
+    // commands are registered right away, each plugin joins the dispatch once initialized
+    m_commands_started_at = StartupReport::Clock::now();
+    {
+        auto lock = std::unique_lock { m_reload_mutex };
+        rebuildDispatch();
+    }
+
+    m_initializing = std::size(m_plugins);
+    for (auto &plugin : m_plugins)
+        plugin->executor->postContinuation(
+            [this, ready, &plugin = *plugin] { initializePlugin(plugin, ready); });
+
+    m_bot->on_interaction_create([this](const auto &event) {
+        if (!accept(event)) return;
+        if (m_recorder) m_recorder->write(event.raw_event);
+
+        const auto command_name = event.command.get_command_name();
+
+        if (command_name == RELOAD_COMMAND) {
+            const auto name = std::get<std::string>(event.get_parameter("plugin"));
+            queueReload(event, [this, name] { return reloadPlugin(name); }, name);
+
+            return;
+        }
+
+        if (command_name == RELOAD_SETTINGS_COMMAND) {
+            queueReload(event, [this] { return reloadSettings(); }, Settings::PATH);
+
+            return;
+        }
+
+        if (command_name == TRACE_COMMAND) {
+            onTraceCommand(event);
+
+            return;
+        }
+
+        const auto router = m_command_router.get();
+        const auto *route = router->route(event);
+        if (!route) return;
+
+        if (const auto &plugin = *m_plugins[route->plugin]; plugin.failed) {
+            reply(event,
+                  dpp::message { std::format("{} failed to start", plugin.name) }.set_flags(
+                      dpp::m_ephemeral));
+
+            return;
+        } else if (!plugin.initialized) {
+            reply(event,
+                  dpp::message { "Still starting up, try again in a moment" }.set_flags(
+                      dpp::m_ephemeral));
+
+            return;
+        }
+
+        const auto trace_id = m_tracer->startTrace();
+        auto shared         = std::make_shared<const CommandEvent>(
+            event,
+            trace_id,
+            m_tracer->slice(trace_id, 0, "gateway", "INTERACTION_CREATE"));
+
+        auto &plugin = *m_plugins[route->plugin];
+        plugin.executor->post([this, shared, &plugin] {
+            const auto start = std::chrono::steady_clock::now();
+            plugin.latencies.ingest.record(ingestLatency(shared->event.command.id));
+
+            auto slice =
+                m_tracer->slice(shared->trace_id, shared->slice.id(), "onCommand", plugin.name);
+            const auto context = Tracer::Context { shared->trace_id, slice.id() };
+
+            auto instance    = plugin.instance.load();
+            const auto owner = InstanceContext { instance };
+            instance->onCommand(shared->event, *m_bot)
+                .detach(std::make_shared<const InFlight>(shared, instance, std::move(slice)),
+                        logTaskError(plugin.name));
+
+            plugin.latencies.command.record(elapsedSince(start));
+        });
     });
 
     m_bot->on_message_create([this](const auto &event) {
-        for (auto &plugin : m_plugins) { plugin.interface->onMessageReceived(event, *m_bot); }
+        if (!accept(event)) return;
+        if (m_recorder) m_recorder->write(event.raw_event);
+
+        const auto message = std::make_shared<dpp::message>(*event.msg);
+        m_message_cache->insert(message);
+
+        // webhooks and some system messages come without an author
+        const auto own_message = message->author && message->author->id == m_bot->me.id;
+        const auto targets     = m_event_index.get()->messageTargets(message->channel_id,
+                                                                    message->guild_id,
+                                                                    own_message);
+        if (targets == 0) return;
+
+        auto shared      = std::make_shared<MessageEvent>(event, message);
+        shared->trace_id = m_tracer->startTrace();
+        shared->slice    = m_tracer->slice(shared->trace_id, 0, "gateway", "MESSAGE_CREATE");
+
+        // scanned once for every plugin
+        m_compiled_message_scanner.get()->scan(shared->message->content, shared->matches);
+        shared->buildView(m_bot->me.id);
+
+        EventIndex::forEach(targets, [&](auto i) {
+            auto &plugin = *m_plugins[i];
+            plugin.executor->post([this, shared, &plugin] {
+                const auto start = std::chrono::steady_clock::now();
+                plugin.latencies.ingest.record(ingestLatency(shared->message->id));
+
+                auto slice = m_tracer->slice(shared->trace_id,
+                                             shared->slice.id(),
+                                             "onMessageReceived",
+                                             plugin.name);
+                const auto context = Tracer::Context { shared->trace_id, slice.id() };
+
+                auto instance    = plugin.instance.load();
+                const auto owner = InstanceContext { instance };
+                auto in_flight   = std::make_shared<InFlight>(shared, instance, std::move(slice));
+
+                in_flight->view         = shared->view;
+                in_flight->view.scratch = &in_flight->scratch;
+
+                instance->onMessage(in_flight->view, *m_bot)
+                    .detach(std::move(in_flight), logTaskError(plugin.name));
+
+                plugin.latencies.message.record(elapsedSince(start));
+            });
+        });
     });
+
+    // edits may only carry the changed fields, the next lookup goes through REST instead
+    m_bot->on_message_update([this](const auto &event) {
+        if (accept(event) && event.updated) m_message_cache->erase(event.updated->id);
+    });
+    m_bot->on_message_delete([this](const auto &event) {
+        if (accept(event) && event.deleted) m_message_cache->erase(event.deleted->id);
+    });
+    m_bot->on_message_delete_bulk([this](const auto &event) {
+        if (!accept(event)) return;
+
+        for (const auto id : event.deleted) m_message_cache->erase(id);
+    });
+
+    if (m_mode == Mode::GATEWAY)
+        m_plugin_watcher = std::jthread { [this](std::stop_token token) {
+            watchPlugins(std::move(token));
+        } };
     /*
 
 
@@ -462,4 +2112,157 @@ auto Inquisitor::initializeBot() -> void {
         m_bot->initBot(9, "Bot " + m_token, m_asio_context);*/
 }
 
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::initializeInstance(Plugin &plugin,
+                                    PluginInterface &instance,
+                                    std::vector<const PluginInterface *> others) -> void {
+    const auto first    = m_message_scanner.nextKeyword();
+    const auto features = m_message_scanner.features();
+    m_message_scanner.disable(features);
+
+    // returns the features enabled by initialize() and restores the previous ones
+    const auto registered = [&] {
+        const auto enabled = m_message_scanner.features();
+        m_message_scanner.disable(enabled);
+        m_message_scanner.enable(features);
+
+        return enabled;
+    };
+
+    try {
+        instance.initialize(m_settings.get()->plugin_options.at(plugin.name),
+                            std::move(others),
+                            *this);
+    } catch (...) {
+        registered();
+        m_message_scanner.eraseKeywords(first, m_message_scanner.nextKeyword());
+
+        throw;
+    }
+
+    const auto enabled = registered();
+
+    // the registrations of a reloaded instance go away with it
+    m_message_scanner.eraseKeywords(plugin.first_keyword, plugin.last_keyword);
+    plugin.first_keyword = first;
+    plugin.last_keyword  = m_message_scanner.nextKeyword();
+    plugin.features      = enabled;
+
+    m_message_scanner.disable(m_message_scanner.features());
+    for (const auto &other : m_plugins) m_message_scanner.enable(other->features);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::initializePlugin(Plugin &plugin, const std::optional<dpp::ready_t> &ready)
+    -> void {
+    plugin.prepared.wait(false);
+
+    const auto start = StartupReport::Clock::now();
+    {
+        auto lock = std::unique_lock { m_reload_mutex };
+
+        // a reload initializes the new instance itself
+        if (!plugin.initialized && !plugin.failed) {
+            auto plugins = std::vector<const PluginInterface *> {};
+            for (const auto &other : m_plugins) plugins.emplace_back(other->instance.load().get());
+
+            try {
+                const auto instance = plugin.instance.load();
+                const auto owner    = InstanceContext { instance };
+                initializeInstance(plugin, *instance, std::move(plugins));
+
+                plugin.initialized = true;
+                rebuildDispatch();
+            } catch (const std::exception &e) {
+                elog("Failed to initialize {}, reason: {}", plugin.name, e.what());
+                plugin.failed = true;
+            }
+        }
+    }
+    m_startup.record("initialize", plugin.name, start, true);
+
+    // the READY which triggered the initialization was dispatched before the plugin subscribed
+    auto instance = plugin.instance.load();
+    if (plugin.initialized && ready && (instance->subscription().events &
+                                        PluginInterface::Subscription::READY)) {
+        const auto owner       = InstanceContext { instance };
+        const auto ready_start = std::chrono::steady_clock::now();
+        instance->onReady(*ready, *m_bot);
+        plugin.latencies.ready.record(elapsedSince(ready_start));
+    }
+
+    if (--m_initializing == 0) m_initializing.notify_all();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Inquisitor::rebuildDispatch() -> void {
+    auto routes        = std::vector<CommandRouter::Route> {};
+    auto commands      = std::vector<dpp::slashcommand> {};
+    auto subscriptions = std::vector<PluginInterface::Subscription> {};
+
+    for (auto i = 0u; i < std::size(m_plugins); ++i) {
+        const auto instance = m_plugins[i]->instance.load();
+
+        // keeps the plugin indices, an uninitialized plugin receives no events yet
+        auto subscription = PluginInterface::Subscription {};
+        if (m_plugins[i]->initialized) subscription = instance->subscription();
+        else subscription.events = PluginInterface::Subscription::NONE;
+
+        subscriptions.emplace_back(std::move(subscription));
+
+        for (const auto &command : instance->commands()) {
+            routes.emplace_back(CommandRouter::Route { std::string { command.name }, {}, i });
+
+            commands.emplace_back(dpp::slashcommand {}
+                                      .set_name(std::string { command.name })
+                                      .set_description(std::string { command.description })
+                                      .set_application_id(m_bot->me.id)
+                                      .set_type(dpp::ctxm_chat_input));
+        }
+    }
+
+    commands.emplace_back(
+        dpp::slashcommand {}
+            .set_name(RELOAD_COMMAND)
+            .set_description("Reload a plugin")
+            .set_application_id(m_bot->me.id)
+            .set_type(dpp::ctxm_chat_input)
+            .set_default_permissions(dpp::p_administrator)
+            .add_option(dpp::command_option { dpp::co_string, "plugin", "Plugin name", true }));
+
+    commands.emplace_back(
+        dpp::slashcommand {}
+            .set_name(TRACE_COMMAND)
+            .set_description("Control event tracing")
+            .set_application_id(m_bot->me.id)
+            .set_type(dpp::ctxm_chat_input)
+            .set_default_permissions(dpp::p_administrator)
+            .add_option(dpp::command_option { dpp::co_string, "action", "Action", true }
+                            .add_choice(choiceOf("start"))
+                            .add_choice(choiceOf("stop"))
+                            .add_choice(choiceOf("dump")))
+            .add_option(dpp::command_option { dpp::co_integer,
+                                              "sample_every",
+                                              "Trace one event out of sample_every",
+                                              false }));
+
+    commands.emplace_back(dpp::slashcommand {}
+                              .set_name(RELOAD_SETTINGS_COMMAND)
+                              .set_description("Reload settings.json")
+                              .set_application_id(m_bot->me.id)
+                              .set_type(dpp::ctxm_chat_input)
+                              .set_default_permissions(dpp::p_administrator));
+
+    m_event_index.publish(EventIndex { subscriptions });
+
+    auto scanner = m_message_scanner;
+    scanner.compile();
+    m_compiled_message_scanner.publish(std::move(scanner));
+
+    registerCommands(std::move(routes), std::move(commands));
+}
+
 #pragma pop_macro("interface")
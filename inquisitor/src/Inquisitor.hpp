@@ -5,8 +5,26 @@
 #pragma once
 
 #include "CoreDependencies.hpp"
+#include "Arena.hpp"
+#include "CacheBudget.hpp"
+#include "CommandRouter.hpp"
+#include "CommandState.hpp"
+#include "Downloader.hpp"
+#include "EventIndex.hpp"
+#include "EventLog.hpp"
+#include "GatewayStats.hpp"
+#include "MessageCache.hpp"
+#include "Executor.hpp"
+#include "Metrics.hpp"
+#include "Outbound.hpp"
+#include "RequestScheduler.hpp"
+#include "SessionStore.hpp"
+#include "Settings.hpp"
+#include "Snapshot.hpp"
+#include "StartupReport.hpp"
+#include "Tracer.hpp"
 
-class Inquisitor final: public stormkit::core::App {
+class Inquisitor final: public stormkit::core::App, public CoreServices {
   public:
     using json = nlohmann::json;
 
@@ -14,34 +32,210 @@ class Inquisitor final: public stormkit::core::App {
     static constexpr auto MINOR_VERSION = 0;
     static constexpr auto PATCH_VERSION = 0;
 
-    Inquisitor() noexcept;
+    enum class Mode {
+        GATEWAY,
+        // no gateway connection and a placeholder token, restCall() requests complete in
+        // process with an empty result
+        REPLAY,
+    };
+
+    // owns the shards where shard_id % sharding.clusters == cluster_id. Throws if a plugin
+    // options don't validate
+    explicit Inquisitor(stormkit::core::UInt32 cluster_id = 0, Mode mode = Mode::GATEWAY);
     ~Inquisitor() override;
 
+    // returns once stop() was called and the work in flight was drained
     auto run(const stormkit::core::Int32 argc, const char **argv) -> stormkit::core::Int32 override;
 
+    // safe to call from any thread, events received afterward aren't dispatched anymore. They
+    // are replayed to the next process which resumes the saved sessions
     auto stop() noexcept -> void;
 
-  private:
-    auto parseSettings() -> void;
-    auto loadPlugins() -> void;
-    auto loadPlugin(const std::filesystem::path &path) -> void;
-    auto initializeBot() -> void;
+    [[nodiscard]] auto messageScanner() noexcept -> MessageScanner & override;
+    [[nodiscard]] auto resumer() -> Resumer override;
+    auto sendRequest(std::string_view name,
+                     Priority priority,
+                     Request request,
+                     Completion on_completion,
+                     dpp::snowflake major = {}) -> void override;
+    [[nodiscard]] auto cachedMessage(dpp::snowflake id)
+        -> std::shared_ptr<const dpp::message> override;
+    auto cacheMessage(const dpp::message &message) -> void override;
+    auto reply(const dpp::interaction_create_t &event, dpp::message message) -> void override;
+    auto deleteMessage(dpp::snowflake id, dpp::snowflake channel_id) -> void override;
+    auto addReaction(const dpp::message &message, std::string_view emoji) -> void override;
+    [[nodiscard]] auto download(DownloadRequest request) -> std::future<DownloadResult> override;
 
-    std::atomic_bool m_run = true;
+    // swaps the plugin library in place, other plugins keep processing events meanwhile
+    auto reloadPlugin(std::string_view name) -> bool;
+    // keeps the current settings if the file doesn't validate
+    auto reloadSettings() -> bool;
 
-    std::string m_token;
-    std::string m_hello_channel_id;
+    // feeds an EventLog through the dispatch handlers, returns the number of replayed events.
+    // Only the events of the shards owned by this cluster are replayed. Interactions reach
+    // onCommand(), their replies complete in process
+    auto replay(const std::filesystem::path &path) -> std::size_t;
+    auto waitIdle() -> void;
+    [[nodiscard]] auto executors() const -> std::vector<const Executor *>;
+
+  private:
+    using Instance = std::shared_ptr<PluginInterface>;
+
+    // time spent in each hook until it returns or first suspends, and time from the message /
+    // interaction creation to the start of its handler
+    struct Latencies {
+        LatencyHistogram ready;
+        LatencyHistogram command;
+        LatencyHistogram message;
+        LatencyHistogram ingest;
+    };
 
     struct Plugin {
+        std::string name;
         std::filesystem::path path;
-        stormkit::core::DynamicLoader loader;
+        std::unique_ptr<Executor> executor;
+        Latencies latencies;
+
+        // set once prepare() returned, then once initialize() did. Commands routed to a plugin
+        // which isn't initialized yet are answered by the core
+        std::atomic_bool prepared    = false;
+        std::atomic_bool initialized = false;
+        // prepare() or initialize() threw, the plugin stays out of the dispatch until reloaded
+        // and its commands are answered with an error
+        std::atomic_bool failed = false;
+
+        // swapped on reload, in flight callbacks keep the previous instance alive
+        std::atomic<Instance> instance;
+
+        // registered into the message scanner by the current instance, under m_reload_mutex
+        MessageScanner::KeywordID first_keyword = 0;
+        MessageScanner::KeywordID last_keyword  = 0;
+        MessageScanner::Features features       = MessageScanner::NONE;
+    };
+
+    // instance which isn't referenced anymore, neither by a callback nor by a request in flight.
+    // Its library is closed on the next reap
+    struct Retired {
+        std::string name;
+        std::shared_ptr<stormkit::core::DynamicLoader> loader;
+        std::function<void(PluginInterface *)> deallocate;
         PluginInterface *interface;
     };
 
-    std::vector<std::string> m_enabled_plugins;
-    std::vector<Plugin> m_plugins;
+    struct ReloadRequest {
+        std::function<bool()> reload;
+        std::function<void(bool)> on_done;
+    };
+
+    auto parseSettings() const -> Settings;
+    auto loadPlugins() -> void;
+    auto validatePluginOptions(const Settings &settings, const Settings *previous) const -> bool;
+    // queued once the options validated, a plugin failing to prepare is marked failed
+    auto preparePlugins() -> void;
+    auto loadPlugin(const std::string &name, const std::filesystem::path &path)
+        -> std::unique_ptr<Plugin>;
+    auto instantiate(const std::string &name, const std::filesystem::path &path) -> Instance;
+    auto retire(Retired retired) -> void;
+    auto reapRetiredPlugins() -> void;
+    auto watchPlugins(std::stop_token token) -> void;
+    auto onTraceCommand(const dpp::interaction_create_t &event) -> void;
+    auto queueReload(const dpp::interaction_create_t &event,
+                     std::function<bool()> reload,
+                     std::string what) -> void;
+    // ready is handed to the plugins once initialized, std::nullopt for a resumed session and in
+    // replay mode where the recorded READY is dispatched afterward
+    auto initializeBot(std::optional<dpp::ready_t> ready) -> void;
+    // under m_reload_mutex, throws what initialize() threw. The message scanner registrations of
+    // the previous instance are replaced by the new ones
+    auto initializeInstance(Plugin &plugin,
+                            PluginInterface &instance,
+                            std::vector<const PluginInterface *> others) -> void;
+    auto initializePlugin(Plugin &plugin, const std::optional<dpp::ready_t> &ready) -> void;
+    auto rebuildDispatch() -> void;
+    auto registerCommands(std::vector<CommandRouter::Route> routes,
+                          std::vector<dpp::slashcommand> commands) -> void;
+    auto publishCommandIds(std::vector<CommandRouter::Route> routes, const CommandState &state)
+        -> void;
+    auto commandsReady() -> void;
+    auto logExecutorStats() const -> void;
+    auto logLatencies() const -> void;
+    auto logRequestStats() const -> void;
+    auto logMessageCacheStats() const -> void;
+    auto logGatewayStats() const -> void;
+    auto logCacheStats() const -> void;
+    auto logDownloadStats() const -> void;
+    [[nodiscard]] auto cachePolicy(const Settings::Cache &cache) const -> dpp::cache_policy_t;
+    auto measureGateway() -> void;
+    // false once stopping, otherwise records the sequence of the event as dispatched
+    auto accept(const dpp::event_dispatch_t &event) -> bool;
+    auto drain() -> void;
+    // creates and runs the shards of this cluster, the saved sessions are seeded beforehand
+    auto connect(const std::optional<SessionStore::State> &sessions) -> void;
+    auto saveSessions() -> void;
+    [[nodiscard]] auto metricsReport() const -> std::string;
+
+    stormkit::core::UInt32 m_cluster_id;
+    Mode m_mode;
+
+    StartupReport m_startup;
+    StartupReport::Clock::time_point m_connect_started_at;
+    StartupReport::Clock::time_point m_commands_started_at;
+    std::atomic_bool m_commands_ready = false;
+    // plugins still initializing, replay() waits for them
+    std::atomic<std::size_t> m_initializing = 0;
+
+    std::atomic_bool m_run = true;
+    std::once_flag m_initialized;
+
+    std::string m_hello_channel_id;
+
+    std::vector<std::unique_ptr<Plugin>> m_plugins;
+
+    Snapshot<Settings> m_settings;
 
-    stormkit::core::HashMap<std::string, json> m_plugin_options;
+    std::unique_ptr<EventLogWriter> m_recorder;
+    std::unique_ptr<SessionStore> m_session_store;
+    std::mutex m_save_mutex;
 
+    // filled from the shard threads as READY and dispatched events come
+    std::mutex m_sessions_mutex;
+    SessionStore::State m_sessions;
+    std::unique_ptr<Tracer> m_tracer;
+    std::unique_ptr<MessageCache> m_message_cache;
+    // only set when gateway.measure is enabled
+    std::unique_ptr<GatewayStats> m_gateway_stats;
+    std::unique_ptr<CacheBudget> m_cache_budget;
+    // outlives the plugin executors, their callbacks may wait on downloads
+    std::unique_ptr<Downloader> m_downloader;
+
+    Snapshot<CommandRouter> m_command_router;
+    Snapshot<EventIndex> m_event_index;
+
+    // plugins register into m_message_scanner, the event threads read the compiled copy
+    MessageScanner m_message_scanner;
+    Snapshot<MessageScanner> m_compiled_message_scanner;
+
+    std::mutex m_reload_mutex;
+    std::size_t m_reload_count = 0;
+    // last command set requested, rebuildDispatch() runs once per initialized plugin. Cleared
+    // when the registration fails
+    std::string m_registered_fingerprint;
+
+    std::mutex m_retired_mutex;
+    std::vector<Retired> m_retired;
+
+    std::mutex m_reload_requests_mutex;
+    std::vector<ReloadRequest> m_reload_requests;
+
+    // outlives m_bot, completions of requests in flight can come until the bot is destroyed
+    RequestScheduler m_scheduler;
+
+    stormkit::core::UInt32 m_intents = 0;
     std::unique_ptr<dpp::cluster> m_bot;
+    // created by connect() instead of dpp::cluster::start(), destroyed before m_bot
+    std::map<stormkit::core::UInt32, std::unique_ptr<dpp::discord_client>> m_shards;
+    std::unique_ptr<Outbound> m_outbound;
+
+    std::jthread m_plugin_watcher;
+    std::unique_ptr<MetricsServer> m_metrics_server;
 };
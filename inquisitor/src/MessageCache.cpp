@@ -0,0 +1,141 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "MessageCache.hpp"
+
+namespace {
+    // doesn't follow every allocation of the message, the budget is an order of magnitude
+    auto footprintOf(const dpp::message &message) noexcept -> std::size_t {
+        return sizeof(dpp::message) + std::size(message.content) +
+               std::size(message.embeds) * sizeof(dpp::embed) +
+               std::size(message.attachments) * sizeof(dpp::attachment) + 64u;
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+MessageCache::MessageCache(std::size_t budget) : m_shard_budget { budget / SHARDS } {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::insert(const dpp::message &message) -> void {
+    if (m_shard_budget == 0) return;
+
+    insert(std::make_shared<const dpp::message>(message));
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::insert(Message message) -> void {
+    if (m_shard_budget == 0) return;
+
+    const auto id    = static_cast<std::uint64_t>(message->id);
+    const auto bytes = footprintOf(*message);
+    if (bytes > m_shard_budget) return;
+
+    auto &shard = shardOf(id);
+    auto lock   = std::unique_lock { shard.mutex };
+
+    if (const auto it = shard.index.find(id); it != std::ranges::end(shard.index))
+        remove(shard, it->second);
+
+    evict(shard, bytes);
+
+    shard.index.emplace(id, std::size(shard.entries));
+    shard.entries.emplace_back(Entry { id, std::move(message), bytes, false });
+    shard.bytes += bytes;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::erase(dpp::snowflake id) -> void {
+    auto &shard = shardOf(static_cast<std::uint64_t>(id));
+    auto lock   = std::unique_lock { shard.mutex };
+
+    const auto it = shard.index.find(static_cast<std::uint64_t>(id));
+    if (it == std::ranges::end(shard.index)) return;
+
+    remove(shard, it->second);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::find(dpp::snowflake id) -> Message {
+    auto &shard = shardOf(static_cast<std::uint64_t>(id));
+    auto lock   = std::unique_lock { shard.mutex };
+
+    const auto it = shard.index.find(static_cast<std::uint64_t>(id));
+    if (it == std::ranges::end(shard.index)) {
+        ++shard.misses;
+        return nullptr;
+    }
+
+    ++shard.hits;
+
+    auto &entry      = shard.entries[it->second];
+    entry.referenced = true;
+
+    return entry.message;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::stats() const -> Stats {
+    auto stats = Stats {};
+
+    for (const auto &shard : m_shards) {
+        auto lock = std::unique_lock { shard.mutex };
+
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.entries += std::size(shard.entries);
+        stats.bytes += shard.bytes;
+    }
+
+    return stats;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::shardOf(std::uint64_t id) noexcept -> Shard & {
+    // the low bits of a snowflake are a per process increment which mostly stays at 0, the
+    // millisecond timestamp above them is mixed in to spread the ids
+    return m_shards[(id ^ (id >> 22)) % SHARDS];
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::evict(Shard &shard, std::size_t needed) -> void {
+    while (!std::empty(shard.entries) && shard.bytes + needed > m_shard_budget) {
+        if (shard.hand >= std::size(shard.entries)) shard.hand = 0;
+
+        auto &entry = shard.entries[shard.hand];
+        if (entry.referenced) {
+            entry.referenced = false;
+            ++shard.hand;
+
+            continue;
+        }
+
+        remove(shard, shard.hand);
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MessageCache::remove(Shard &shard, std::size_t position) -> void {
+    auto &entry = shard.entries[position];
+
+    shard.bytes -= entry.bytes;
+    shard.index.erase(entry.id);
+
+    // the last entry takes the freed slot, the hand then looks at it next
+    if (position != std::size(shard.entries) - 1) {
+        entry                 = std::move(shard.entries.back());
+        shard.index[entry.id] = position;
+    }
+
+    shard.entries.pop_back();
+}
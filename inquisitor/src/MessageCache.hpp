@@ -0,0 +1,62 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Recently seen messages keyed by snowflake, bounded by an approximate memory budget. The cache is
+// split in shards each evicting with its own CLOCK hand, so lookups from several plugin threads
+// rarely contend
+class MessageCache {
+  public:
+    using Message = std::shared_ptr<const dpp::message>;
+
+    static constexpr auto SHARDS = std::size_t { 16 };
+
+    struct Stats {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t entries;
+        std::size_t bytes;
+    };
+
+    // a budget of 0 disables the cache
+    explicit MessageCache(std::size_t budget);
+
+    // replaces the cached message with the same id, the first overload copies the message
+    auto insert(const dpp::message &message) -> void;
+    auto insert(Message message) -> void;
+    auto erase(dpp::snowflake id) -> void;
+
+    [[nodiscard]] auto find(dpp::snowflake id) -> Message;
+
+    [[nodiscard]] auto stats() const -> Stats;
+
+  private:
+    struct Entry {
+        std::uint64_t id;
+        Message message;
+        std::size_t bytes;
+        bool referenced;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        stormkit::core::HashMap<std::uint64_t, std::size_t> index;
+        std::vector<Entry> entries;
+        std::size_t hand  = 0;
+        std::size_t bytes = 0;
+
+        std::size_t hits   = 0;
+        std::size_t misses = 0;
+    };
+
+    [[nodiscard]] auto shardOf(std::uint64_t id) noexcept -> Shard &;
+    auto evict(Shard &shard, std::size_t needed) -> void;
+    auto remove(Shard &shard, std::size_t position) -> void;
+
+    std::size_t m_shard_budget;
+    std::array<Shard, SHARDS> m_shards;
+};
@@ -0,0 +1,150 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Metrics.hpp"
+
+#if defined(__linux__)
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+using namespace stormkit;
+
+namespace {
+    constexpr auto ACCEPT_POLL_TIMEOUT = 250;
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto LatencyHistogram::record(std::chrono::microseconds value) noexcept -> void {
+    static thread_local const auto stripe =
+        std::hash<std::thread::id> {}(std::this_thread::get_id()) % STRIPES;
+
+    const auto bucket = bucketOf(static_cast<core::UInt64>(std::max<core::Int64>(value.count(), 0)));
+
+    m_stripes[stripe].buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto LatencyHistogram::summary() const -> Summary {
+    auto buckets = std::array<core::UInt64, BUCKETS> {};
+    auto summary = Summary {};
+
+    for (const auto &stripe : m_stripes) {
+        for (auto i = 0u; i < BUCKETS; ++i) {
+            const auto count = stripe.buckets[i].load(std::memory_order_relaxed);
+
+            buckets[i] += count;
+            summary.count += count;
+        }
+    }
+
+    if (summary.count == 0) return summary;
+
+    const auto rankOf = [&](double quantile) {
+        return std::max<core::UInt64>(
+            static_cast<core::UInt64>(std::ceil(quantile * static_cast<double>(summary.count))),
+            1);
+    };
+
+    const auto p50_rank  = rankOf(0.5);
+    const auto p99_rank  = rankOf(0.99);
+    const auto p999_rank = rankOf(0.999);
+
+    auto seen = core::UInt64 { 0 };
+    for (auto i = 0u; i < BUCKETS; ++i) {
+        if (buckets[i] == 0) continue;
+
+        const auto previous = seen;
+        seen += buckets[i];
+
+        const auto value = upperBoundOf(i);
+        if (previous < p50_rank && seen >= p50_rank) summary.p50 = value;
+        if (previous < p99_rank && seen >= p99_rank) summary.p99 = value;
+        if (previous < p999_rank && seen >= p999_rank) summary.p999 = value;
+
+        summary.max = value;
+    }
+
+    return summary;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+MetricsServer::MetricsServer(core::UInt16 port, Report report) : m_report { std::move(report) } {
+#if defined(__linux__)
+    const auto fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        elog("Failed to create the metrics socket, reason: {}", std::strerror(errno));
+        return;
+    }
+
+    const auto reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    auto address            = sockaddr_in {};
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 ||
+        listen(fd, 8) < 0) {
+        elog("Failed to listen on 127.0.0.1:{}, reason: {}", port, std::strerror(errno));
+        ::close(fd);
+        return;
+    }
+
+    ilog("Serving metrics on 127.0.0.1:{}", port);
+
+    m_thread = std::jthread { [this, fd](std::stop_token token) { serve(std::move(token), fd); } };
+#else
+    wlog("Metrics endpoint on port {} not started, only available on Linux", port);
+#endif
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MetricsServer::serve([[maybe_unused]] std::stop_token token, [[maybe_unused]] int fd)
+    -> void {
+#if defined(__linux__)
+    while (!token.stop_requested()) {
+        auto poll_fd = pollfd { fd, POLLIN, 0 };
+        if (::poll(&poll_fd, 1, ACCEPT_POLL_TIMEOUT) <= 0) continue;
+
+        const auto client = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;
+
+        // the request itself is ignored, every path serves the same report. It's still read so
+        // closing the socket doesn't reset the connection before the client reads the response
+        auto client_fd = pollfd { client, POLLIN, 0 };
+        if (::poll(&client_fd, 1, ACCEPT_POLL_TIMEOUT) > 0) {
+            auto request = std::array<char, 1024> {};
+            recv(client, std::data(request), std::size(request), MSG_DONTWAIT);
+        }
+
+        const auto body     = m_report();
+        const auto response = std::format("HTTP/1.0 200 OK\r\nContent-Type: text/plain; "
+                                          "version=0.0.4\r\nContent-Length: {}\r\n\r\n{}",
+                                          std::size(body),
+                                          body);
+
+        for (auto sent = std::size_t { 0 }; sent < std::size(response);) {
+            const auto count =
+                send(client, std::data(response) + sent, std::size(response) - sent, MSG_NOSIGNAL);
+            if (count <= 0) break;
+
+            sent += static_cast<std::size_t>(count);
+        }
+
+        shutdown(client, SHUT_RDWR);
+        ::close(client);
+    }
+
+    ::close(fd);
+#endif
+}
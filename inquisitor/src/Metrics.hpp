@@ -0,0 +1,76 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Log-linear latency histogram in microseconds (HDR style, 16 sub buckets per power of two, so
+// about 6% precision). Writers only bump relaxed atomics in the stripe of their thread, the
+// stripes are merged on read.
+class LatencyHistogram {
+  public:
+    struct Summary {
+        stormkit::core::UInt64 count = 0;
+        stormkit::core::UInt64 p50   = 0;
+        stormkit::core::UInt64 p99   = 0;
+        stormkit::core::UInt64 p999  = 0;
+        stormkit::core::UInt64 max   = 0;
+    };
+
+    auto record(std::chrono::microseconds value) noexcept -> void;
+
+    [[nodiscard]] auto summary() const -> Summary;
+
+  private:
+    static constexpr auto SUB_BUCKET_BITS = 4u;
+    static constexpr auto SUB_BUCKETS     = 1u << SUB_BUCKET_BITS;
+    // values above 2^40us (~12 days) land in the last bucket
+    static constexpr auto MAX_SHIFT = 36u;
+    static constexpr auto BUCKETS   = (MAX_SHIFT + 2u) * SUB_BUCKETS;
+    static constexpr auto STRIPES   = 4u;
+
+    [[nodiscard]] static constexpr auto bucketOf(stormkit::core::UInt64 value) noexcept
+        -> std::size_t {
+        if (value < SUB_BUCKETS) return value;
+
+        const auto shift = static_cast<stormkit::core::UInt64>(std::bit_width(value)) -
+                           SUB_BUCKET_BITS - 1u;
+        if (shift > MAX_SHIFT) return BUCKETS - 1u;
+
+        return (shift + 1u) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    }
+
+    [[nodiscard]] static constexpr auto upperBoundOf(std::size_t bucket) noexcept
+        -> stormkit::core::UInt64 {
+        if (bucket < SUB_BUCKETS) return bucket;
+
+        const auto shift = bucket / SUB_BUCKETS - 1u;
+        const auto sub   = bucket % SUB_BUCKETS;
+
+        return ((stormkit::core::UInt64 { SUB_BUCKETS + sub + 1u }) << shift) - 1u;
+    }
+
+    struct alignas(64) Stripe {
+        std::array<std::atomic<stormkit::core::UInt64>, BUCKETS> buckets {};
+    };
+
+    std::array<Stripe, STRIPES> m_stripes;
+};
+
+// Serves the text returned by report to every connection on 127.0.0.1:port, as a minimal
+// HTTP response so curl or a prometheus scraper can read it. Linux only, nothing is served
+// elsewhere
+class MetricsServer {
+  public:
+    using Report = std::function<std::string()>;
+
+    MetricsServer(stormkit::core::UInt16 port, Report report);
+
+  private:
+    auto serve(std::stop_token token, int fd) -> void;
+
+    Report m_report;
+    std::jthread m_thread;
+};
@@ -0,0 +1,197 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Outbound.hpp"
+
+using namespace stormkit;
+
+namespace {
+    auto logError(std::string_view what) -> CoreServices::Completion {
+        return [what](const auto &result) {
+            if (result.is_error())
+                elog("{} failed, reason: {}", what, result.get_error().message);
+        };
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+Outbound::Outbound(dpp::cluster &bot, CoreServices &core)
+    : m_bot { &bot }, m_core { &core },
+      m_thread { [this](std::stop_token token) { run(std::move(token)); } } {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Outbound::~Outbound() {
+    m_thread.request_stop();
+    m_thread.join();
+
+    flush();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Outbound::deleteMessage(dpp::snowflake id, dpp::snowflake channel_id) -> void {
+    auto lock = std::unique_lock { m_mutex };
+
+    auto &deletes = m_deletes[static_cast<std::uint64_t>(channel_id)];
+    if (std::ranges::find(deletes, id, &Delete::id) != std::ranges::end(deletes)) return;
+
+    deletes.emplace_back(Delete { id, Tracer::current(), Tracer::currentSlice() });
+
+    if (!m_deadline) m_deadline = Clock::now() + WINDOW;
+
+    lock.unlock();
+    m_pending.notify_one();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Outbound::addReaction(dpp::snowflake id, dpp::snowflake channel_id, std::string_view emoji)
+    -> void {
+    const auto now = Clock::now();
+
+    auto lock = std::unique_lock { m_mutex };
+
+    const auto [it, inserted] =
+        m_reacted.try_emplace(std::format("{}:{}", static_cast<std::uint64_t>(id), emoji), now);
+    if (!inserted && now - it->second < REACTION_TTL) return;
+
+    it->second = now;
+    m_reactions.emplace_back(Reaction { id,
+                                        channel_id,
+                                        std::string { emoji },
+                                        Tracer::current(),
+                                        Tracer::currentSlice() });
+
+    if (!m_deadline) m_deadline = now + WINDOW;
+
+    lock.unlock();
+    m_pending.notify_one();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Outbound::run(std::stop_token token) -> void {
+    while (!token.stop_requested()) {
+        {
+            auto lock = std::unique_lock { m_mutex };
+            if (!m_pending.wait(lock, token, [this] { return m_deadline.has_value(); })) return;
+
+            // only a stop request interrupts the window
+            const auto deadline = *m_deadline;
+            m_pending.wait_until(lock, token, deadline, [] { return false; });
+        }
+
+        flush();
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Outbound::flush() -> void {
+    auto lock = std::unique_lock { m_mutex };
+
+    auto deletes   = std::exchange(m_deletes, {});
+    auto reactions = std::exchange(m_reactions, {});
+    m_deadline.reset();
+
+    const auto now = Clock::now();
+    std::erase_if(m_reacted, [&](const auto &entry) { return now - entry.second >= REACTION_TTL; });
+
+    lock.unlock();
+
+    for (auto &&[channel_id, messages] : deletes) sendDeletes(channel_id, std::move(messages));
+
+    for (auto &reaction : reactions) {
+        const auto channel_id = reaction.channel_id;
+        const auto context    = Tracer::Context { reaction.trace, reaction.parent };
+
+        m_core->sendRequest(
+            "message_add_reaction",
+            Priority::HOUSEKEEPING,
+            [bot = m_bot, reaction = std::move(reaction)](auto callback) {
+                bot->message_add_reaction(reaction.id,
+                                          reaction.channel_id,
+                                          reaction.emoji,
+                                          std::move(callback));
+            },
+            logError("message_add_reaction"),
+            channel_id);
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Outbound::sendDeletes(dpp::snowflake channel_id, std::vector<Delete> deletes) -> void {
+    const auto oldest_bulk = std::chrono::duration<double>(
+                                 std::chrono::system_clock::now().time_since_epoch() - MAX_BULK_AGE)
+                                 .count();
+
+    const auto old = std::ranges::partition(deletes, [&](const auto &message) {
+        return message.id.get_creation_time() >= oldest_bulk;
+    });
+
+    auto singles = std::vector<Delete> { std::ranges::begin(old), std::ranges::end(old) };
+    deletes.erase(std::ranges::begin(old), std::ranges::end(deletes));
+
+    for (auto first = std::size_t { 0 }; first < std::size(deletes); first += MAX_BULK_SIZE) {
+        const auto last = std::min(first + MAX_BULK_SIZE, std::size(deletes));
+
+        // a bulk delete needs at least two messages
+        if (last - first == 1) {
+            singles.emplace_back(deletes[first]);
+            continue;
+        }
+
+        auto chunk =
+            std::vector<Delete> { std::begin(deletes) + first, std::begin(deletes) + last };
+        auto ids   = std::vector<dpp::snowflake> {};
+        ids.reserve(std::size(chunk));
+        for (const auto &message : chunk) ids.emplace_back(message.id);
+
+        const auto context = Tracer::Context { chunk.front().trace, chunk.front().parent };
+
+        m_core->sendRequest(
+            "message_delete_bulk",
+            Priority::HOUSEKEEPING,
+            [bot = m_bot, channel_id, ids = std::move(ids)](auto callback) {
+                bot->message_delete_bulk(ids, channel_id, std::move(callback));
+            },
+            // a message of the chunk may be rejected by the bulk endpoint, the others are still
+            // deleted one by one. May complete after the outbound buffer is gone
+            [core = m_core, bot = m_bot, channel_id, chunk = std::move(chunk)](const auto &result) {
+                if (!result.is_error()) return;
+
+                wlog("message_delete_bulk of {} messages failed, reason: {}, deleting them one by "
+                     "one",
+                     std::size(chunk),
+                     result.get_error().message);
+
+                for (const auto &message : chunk) sendDelete(*core, *bot, channel_id, message);
+            },
+            channel_id);
+    }
+
+    for (const auto &message : singles) sendDelete(*m_core, *m_bot, channel_id, message);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Outbound::sendDelete(CoreServices &core,
+                          dpp::cluster &bot,
+                          dpp::snowflake channel_id,
+                          Delete message) -> void {
+    const auto context = Tracer::Context { message.trace, message.parent };
+
+    core.sendRequest(
+        "message_delete",
+        Priority::HOUSEKEEPING,
+        [bot = &bot, id = message.id, channel_id](auto callback) {
+            bot->message_delete(id, channel_id, std::move(callback));
+        },
+        logError("message_delete"),
+        channel_id);
+}
@@ -0,0 +1,72 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+#include "Tracer.hpp"
+
+// Buffers outbound moderation requests for a short window. Deletes of a channel are merged into
+// message_delete_bulk calls and identical reactions on a message are only sent once. The requests
+// are traced in the trace of the caller, a bulk delete in the one of its first message
+class Outbound {
+  public:
+    using Clock    = std::chrono::steady_clock;
+    using Priority = CoreServices::Priority;
+
+    static constexpr auto WINDOW        = std::chrono::milliseconds { 250 };
+    static constexpr auto MAX_BULK_SIZE = std::size_t { 100 };
+    // discord refuses to bulk delete messages older than two weeks
+    static constexpr auto MAX_BULK_AGE =
+        std::chrono::hours { 14 * 24 } - std::chrono::minutes { 1 };
+    static constexpr auto REACTION_TTL = std::chrono::minutes { 10 };
+
+    Outbound(dpp::cluster &bot, CoreServices &core);
+    ~Outbound();
+
+    Outbound(const Outbound &)                    = delete;
+    auto operator=(const Outbound &) -> Outbound & = delete;
+
+    auto deleteMessage(dpp::snowflake id, dpp::snowflake channel_id) -> void;
+    auto addReaction(dpp::snowflake id, dpp::snowflake channel_id, std::string_view emoji) -> void;
+
+    // sends what is buffered without waiting for the end of the window
+    auto flush() -> void;
+
+  private:
+    struct Delete {
+        dpp::snowflake id;
+        Tracer::TraceID trace;
+        Tracer::SliceID parent;
+    };
+
+    struct Reaction {
+        dpp::snowflake id;
+        dpp::snowflake channel_id;
+        std::string emoji;
+        Tracer::TraceID trace;
+        Tracer::SliceID parent;
+    };
+
+    auto run(std::stop_token token) -> void;
+    auto sendDeletes(dpp::snowflake channel_id, std::vector<Delete> deletes) -> void;
+    static auto sendDelete(CoreServices &core,
+                           dpp::cluster &bot,
+                           dpp::snowflake channel_id,
+                           Delete message) -> void;
+
+    dpp::cluster *m_bot;
+    CoreServices *m_core;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_pending;
+    std::optional<Clock::time_point> m_deadline;
+
+    stormkit::core::HashMap<std::uint64_t, std::vector<Delete>> m_deletes;
+    std::vector<Reaction> m_reactions;
+    // "<message id>:<emoji>" of the reactions sent during the last REACTION_TTL
+    stormkit::core::HashMap<std::string, Clock::time_point> m_reacted;
+
+    std::jthread m_thread;
+};
@@ -0,0 +1,311 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "RequestScheduler.hpp"
+
+using namespace stormkit;
+
+namespace {
+    // longest sleep while every queued request waits on an exhausted bucket
+    constexpr auto MAX_IDLE_WAIT = std::chrono::seconds { 1 };
+
+    constexpr auto TOO_MANY_REQUESTS = 429u;
+
+    auto header(const dpp::http_request_completion_t &http, std::string_view name)
+        -> std::optional<std::string_view> {
+        const auto it = std::ranges::find_if(http.headers, [&](const auto &entry) {
+            return std::ranges::equal(entry.first, name, [](auto a, auto b) {
+                return std::tolower(static_cast<unsigned char>(a)) == b;
+            });
+        });
+        if (it == std::ranges::cend(http.headers)) return std::nullopt;
+
+        return std::string_view { it->second };
+    }
+
+    auto secondsOf(std::string_view value) -> std::optional<std::chrono::milliseconds> {
+        auto seconds = 0.;
+        if (std::from_chars(std::data(value), std::data(value) + std::size(value), seconds).ec !=
+            std::errc {})
+            return std::nullopt;
+
+        return std::chrono::milliseconds { static_cast<core::Int64>(std::ceil(seconds * 1000.)) };
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+RequestScheduler::RequestScheduler() {
+    for (auto &counters : m_counters) {
+        counters.total_wait = Clock::duration::zero();
+        counters.max_wait   = Clock::duration::zero();
+    }
+
+    m_thread = std::jthread { [this](std::stop_token token) { dispatch(std::move(token)); } };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+RequestScheduler::~RequestScheduler() {
+    stop();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::stop() -> void {
+    if (!m_thread.joinable()) return;
+
+    m_thread.request_stop();
+    m_thread.join();
+
+    auto lock = std::unique_lock { m_mutex };
+
+    auto dropped = std::size_t { 0 };
+    for (auto &queues : m_queues)
+        for (const auto &queue : std::exchange(queues, {})) dropped += std::size(queue.pending);
+
+    if (dropped > 0) wlog("{} queued requests dropped on shutdown", dropped);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::submit(std::string route,
+                              dpp::snowflake major,
+                              Priority priority,
+                              Request request,
+                              Completion on_completion) -> void {
+    auto lock = std::unique_lock { m_mutex };
+
+    auto &queues  = m_queues[static_cast<std::size_t>(priority)];
+    const auto it = std::ranges::find_if(queues, [&](const auto &queue) {
+        return queue.major == major && queue.route == route;
+    });
+
+    auto &queue = (it != std::ranges::end(queues))
+                      ? *it
+                      : queues.emplace_back(Queue { std::move(route), major, {} });
+    queue.pending.emplace_back(
+        Pending { std::move(request), std::move(on_completion), Clock::now() });
+    m_changed = true;
+
+    lock.unlock();
+    m_wake.notify_one();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::stats() const -> std::array<Stats, CLASSES> {
+    auto lock = std::unique_lock { m_mutex };
+
+    auto stats = std::array<Stats, CLASSES> {};
+    for (auto i = 0u; i < CLASSES; ++i) {
+        const auto &counters = m_counters[i];
+
+        const auto average_wait =
+            (counters.sent > 0) ? counters.total_wait / static_cast<Clock::rep>(counters.sent)
+                                : Clock::duration::zero();
+
+        auto depth = std::size_t { 0 };
+        for (const auto &queue : m_queues[i]) depth += std::size(queue.pending);
+
+        stats[i] = Stats {
+            .depth        = depth,
+            .sent         = counters.sent,
+            .average_wait = std::chrono::duration_cast<std::chrono::microseconds>(average_wait),
+            .max_wait     = std::chrono::duration_cast<std::chrono::microseconds>(counters.max_wait)
+        };
+    }
+
+    return stats;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::pending() const -> std::size_t {
+    auto lock = std::unique_lock { m_mutex };
+
+    auto pending = std::size_t { 0 };
+    for (const auto &queues : m_queues)
+        for (const auto &queue : queues) pending += std::size(queue.pending);
+    for (const auto &[_, majors] : m_buckets)
+        for (const auto &[_, bucket] : majors) pending += bucket.in_flight;
+
+    return pending;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::className(Priority priority) noexcept -> std::string_view {
+    switch (priority) {
+        case Priority::INTERACTION: return "interaction";
+        case Priority::REPLY: return "reply";
+        case Priority::HOUSEKEEPING: return "housekeeping";
+    }
+
+    return "unknown";
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::dispatch(std::stop_token token) -> void {
+    auto lock = std::unique_lock { m_mutex };
+
+    while (!token.stop_requested()) {
+        const auto now = Clock::now();
+
+        auto next     = std::optional<Pending> {};
+        auto route    = std::string {};
+        auto major    = core::UInt64 { 0 };
+        auto priority = std::size_t { 0 };
+
+        // highest class first, inside a class the oldest request whose bucket has budget. The
+        // requests of a queue share their bucket so they leave in order
+        for (auto i = 0u; i < CLASSES && !next; ++i) {
+            auto &queues = m_queues[i];
+
+            auto oldest = std::ranges::end(queues);
+            for (auto it = std::ranges::begin(queues); it != std::ranges::end(queues); ++it) {
+                if (oldest != std::ranges::end(queues) &&
+                    oldest->pending.front().enqueued_at <= it->pending.front().enqueued_at)
+                    continue;
+
+                if (hasBudget(it->route, it->major, now)) oldest = it;
+            }
+            if (oldest == std::ranges::end(queues)) continue;
+
+            next = std::move(oldest->pending.front());
+            oldest->pending.pop_front();
+            route    = oldest->route;
+            major    = oldest->major;
+            priority = i;
+
+            if (std::empty(oldest->pending)) {
+                std::swap(*oldest, queues.back());
+                queues.pop_back();
+            }
+        }
+
+        if (!next) {
+            auto wake_at = now + MAX_IDLE_WAIT;
+            for (const auto &[_, majors] : m_buckets)
+                for (const auto &[_, bucket] : majors)
+                    if (bucket.remaining && *bucket.remaining <= 0 && bucket.reset_at > now)
+                        wake_at = std::min(wake_at, bucket.reset_at);
+
+            // woken early by a submission or a completion
+            m_wake.wait_until(lock, token, wake_at, [this] { return m_changed; });
+            m_changed = false;
+
+            continue;
+        }
+
+        auto &counters    = m_counters[priority];
+        const auto waited = now - next->enqueued_at;
+        ++counters.sent;
+        counters.total_wait += waited;
+        counters.max_wait = std::max(counters.max_wait, waited);
+
+        auto &bucket = bucketOf(route, major);
+        ++bucket.in_flight;
+        if (bucket.remaining) --*bucket.remaining;
+
+        lock.unlock();
+
+        next->request([this,
+                       route         = std::move(route),
+                       major,
+                       on_completion = std::move(next->on_completion)](const auto &result) {
+            learn(route, major, result.http_info);
+            m_wake.notify_one();
+
+            on_completion(result);
+        });
+
+        lock.lock();
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::hasBudget(const std::string &route,
+                                 core::UInt64 major,
+                                 Clock::time_point now) -> bool {
+    auto &bucket = bucketOf(route, major);
+
+    if (!bucket.remaining) return bucket.in_flight < UNKNOWN_IN_FLIGHT;
+
+    if (*bucket.remaining > 0) return true;
+
+    // the window is over, probe it with one request until the response tells the new budget
+    return bucket.reset_at <= now && bucket.in_flight == 0;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::bucketOf(const std::string &route, core::UInt64 major) -> Bucket & {
+    const auto it = m_route_buckets.find(route);
+    if (it == std::ranges::end(m_route_buckets)) return m_buckets[route][major];
+
+    return m_buckets[it->second][major];
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RequestScheduler::learn(const std::string &route,
+                             core::UInt64 major,
+                             const dpp::http_request_completion_t &http) -> void {
+    const auto now = Clock::now();
+
+    auto lock = std::unique_lock { m_mutex };
+
+    m_changed = true;
+
+    auto &sent_from = bucketOf(route, major);
+    if (sent_from.in_flight > 0) --sent_from.in_flight;
+
+    // first response of the route, its probe buckets are merged into the shared ones
+    if (const auto hash = header(http, "x-ratelimit-bucket");
+        hash && !m_route_buckets.contains(route)) {
+        auto probes = std::move(m_buckets[route]);
+        m_buckets.erase(route);
+
+        auto key     = std::string { *hash };
+        auto &shared = m_buckets[key];
+        for (const auto &[id, probe] : probes) shared[id].in_flight += probe.in_flight;
+
+        m_route_buckets.emplace(route, std::move(key));
+    }
+
+    auto &bucket = bucketOf(route, major);
+
+    // responses of one window may come out of order, the budget only goes down until it's over
+    const auto window_over = !bucket.remaining || bucket.reset_at <= now;
+
+    if (const auto remaining = header(http, "x-ratelimit-remaining"); remaining) {
+        auto value = core::Int64 { 0 };
+        std::from_chars(std::data(*remaining),
+                        std::data(*remaining) + std::size(*remaining),
+                        value);
+
+        // requests sent after this one already took their share of the reported budget
+        const auto left  = value - static_cast<core::Int64>(bucket.in_flight);
+        bucket.remaining = window_over ? left : std::min(*bucket.remaining, left);
+    }
+
+    if (const auto reset_after = header(http, "x-ratelimit-reset-after"); reset_after)
+        if (const auto delay = secondsOf(*reset_after); delay)
+            bucket.reset_at = window_over ? now + *delay : std::max(bucket.reset_at, now + *delay);
+
+    if (http.status == TOO_MANY_REQUESTS) {
+        bucket.remaining = 0;
+
+        if (const auto retry_after = header(http, "retry-after"); retry_after)
+            if (const auto delay = secondsOf(*retry_after); delay)
+                bucket.reset_at = std::max(bucket.reset_at, now + *delay);
+
+        wlog("Rate limited on {}, holding its bucket for {}ms",
+             route,
+             std::chrono::duration_cast<std::chrono::milliseconds>(bucket.reset_at - now).count());
+    }
+}
@@ -0,0 +1,103 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Sends REST requests by priority class, a request is only issued once the rate limit bucket of
+// its route is predicted to have budget left. Buckets are learned from the x-ratelimit-* response
+// headers and split by major parameter, a route whose bucket isn't known yet has at most
+// UNKNOWN_IN_FLIGHT requests in flight
+class RequestScheduler {
+  public:
+    using Clock      = std::chrono::steady_clock;
+    using Priority   = CoreServices::Priority;
+    using Request    = CoreServices::Request;
+    using Completion = CoreServices::Completion;
+
+    static constexpr auto CLASSES           = std::size_t { 3 };
+    static constexpr auto UNKNOWN_IN_FLIGHT = std::size_t { 4 };
+
+    struct Stats {
+        std::size_t depth;
+        std::size_t sent;
+        std::chrono::microseconds average_wait;
+        std::chrono::microseconds max_wait;
+    };
+
+    RequestScheduler();
+    ~RequestScheduler();
+
+    // stops issuing requests, the ones still queued are dropped. Completions of requests in
+    // flight may still come afterward
+    auto stop() -> void;
+
+    RequestScheduler(const RequestScheduler &)                    = delete;
+    auto operator=(const RequestScheduler &) -> RequestScheduler & = delete;
+
+    // route groups the requests sharing a rate limit, the request name is used for it. major is
+    // the channel, guild or webhook id of the request, or 0
+    auto submit(std::string route,
+                dpp::snowflake major,
+                Priority priority,
+                Request request,
+                Completion on_completion) -> void;
+
+    [[nodiscard]] auto stats() const -> std::array<Stats, CLASSES>;
+    // requests queued or waiting for their response
+    [[nodiscard]] auto pending() const -> std::size_t;
+
+    [[nodiscard]] static auto className(Priority priority) noexcept -> std::string_view;
+
+  private:
+    struct Pending {
+        Request request;
+        Completion on_completion;
+        Clock::time_point enqueued_at;
+    };
+
+    // requests of one route and major, in submission order
+    struct Queue {
+        std::string route;
+        stormkit::core::UInt64 major;
+        std::deque<Pending> pending;
+    };
+
+    struct Bucket {
+        std::optional<stormkit::core::Int64> remaining;
+        Clock::time_point reset_at;
+        std::size_t in_flight = 0;
+    };
+
+    struct ClassCounters {
+        std::size_t sent = 0;
+        Clock::duration total_wait;
+        Clock::duration max_wait;
+    };
+
+    auto dispatch(std::stop_token token) -> void;
+    auto hasBudget(const std::string &route, stormkit::core::UInt64 major, Clock::time_point now)
+        -> bool;
+    auto bucketOf(const std::string &route, stormkit::core::UInt64 major) -> Bucket &;
+    auto learn(const std::string &route,
+               stormkit::core::UInt64 major,
+               const dpp::http_request_completion_t &http) -> void;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_wake;
+    bool m_changed = false;
+
+    // only the queues with requests, one per route and major
+    std::array<std::deque<Queue>, CLASSES> m_queues;
+    std::array<ClassCounters, CLASSES> m_counters;
+
+    // route -> bucket hash from x-ratelimit-bucket, buckets of unknown routes are keyed by route
+    stormkit::core::HashMap<std::string, std::string> m_route_buckets;
+    // bucket hash or route -> major -> bucket
+    stormkit::core::HashMap<std::string, stormkit::core::HashMap<stormkit::core::UInt64, Bucket>>
+        m_buckets;
+
+    std::jthread m_thread;
+};
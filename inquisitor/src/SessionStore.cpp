@@ -0,0 +1,86 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "SessionStore.hpp"
+
+using json = nlohmann::json;
+
+/////////////////////////////////////
+/////////////////////////////////////
+SessionStore::SessionStore(std::filesystem::path path) : m_path { std::move(path) } {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto SessionStore::load() const -> std::optional<State> {
+    auto file = std::ifstream { m_path };
+    if (!file) return std::nullopt;
+
+    try {
+        const auto document = json::parse(file);
+
+        auto state     = State {};
+        state.user_id  = document.at("user_id").get<std::uint64_t>();
+        state.username = document.at("username").get<std::string>();
+        state.saved_at = Clock::time_point { std::chrono::milliseconds {
+            document.at("saved_at").get<std::int64_t>() } };
+
+        const auto age = Clock::now() - state.saved_at;
+        if (age > MAX_AGE) {
+            ilog("Gateway sessions saved {}s ago are too old to be resumed",
+                 std::chrono::duration_cast<std::chrono::seconds>(age).count());
+            return std::nullopt;
+        }
+
+        for (const auto &shard : document.at("shards"))
+            state.shards.emplace(shard.at("id").get<stormkit::core::UInt32>(),
+                                 Shard { .session_id = shard.at("session_id").get<std::string>(),
+                                         .sequence   = shard.at("sequence").get<std::uint64_t>() });
+
+        return state;
+    } catch (const std::exception &e) {
+        wlog("Ignoring {}, reason: {}", m_path.string(), e.what());
+    }
+
+    return std::nullopt;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto SessionStore::save(const State &state) const -> void {
+    auto shards = json::array();
+    for (const auto &[id, shard] : state.shards)
+        shards.push_back(json { { "id", id },
+                                { "session_id", shard.session_id },
+                                { "sequence", shard.sequence } });
+
+    const auto saved_at =
+        std::chrono::duration_cast<std::chrono::milliseconds>(state.saved_at.time_since_epoch());
+
+    const auto document = json { { "user_id", static_cast<std::uint64_t>(state.user_id) },
+                                 { "username", state.username },
+                                 { "saved_at", saved_at.count() },
+                                 { "shards", std::move(shards) } };
+
+    auto temporary = m_path;
+    temporary += ".tmp";
+
+    {
+        auto file = std::ofstream { temporary, std::ios::trunc };
+        if (!file) {
+            elog("Failed to save the gateway sessions to {}", temporary.string());
+            return;
+        }
+
+        file << document.dump();
+    }
+
+    auto error = std::error_code {};
+    std::filesystem::rename(temporary, m_path, error);
+    if (error)
+        elog("Failed to save the gateway sessions to {}, reason: {}",
+             m_path.string(),
+             error.message());
+}
+
@@ -0,0 +1,40 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Gateway session of every shard of the cluster, saved so a restart can RESUME them instead of
+// identifying again. The gateway only keeps a session resumable for a little while
+class SessionStore {
+  public:
+    using Clock = std::chrono::system_clock;
+
+    static constexpr auto MAX_AGE = std::chrono::minutes { 2 };
+
+    struct Shard {
+        std::string session_id;
+        // last sequence handed to the plugins, the gateway replays what came after it
+        std::uint64_t sequence;
+    };
+
+    struct State {
+        // READY isn't sent again on a resume, the bot user is restored from here
+        dpp::snowflake user_id;
+        std::string username;
+        stormkit::core::HashMap<stormkit::core::UInt32, Shard> shards;
+        Clock::time_point saved_at;
+    };
+
+    explicit SessionStore(std::filesystem::path path);
+
+    // std::nullopt if there is no state or if it is too old to be resumed
+    [[nodiscard]] auto load() const -> std::optional<State>;
+    // replaces the file atomically
+    auto save(const State &state) const -> void;
+
+  private:
+    std::filesystem::path m_path;
+};
@@ -0,0 +1,97 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Settings.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+    auto parseCachePolicy(const json &cache, std::string_view entity)
+        -> std::optional<Settings::Cache::Policy> {
+        const auto it = cache.find(entity);
+        if (it == std::ranges::cend(cache)) return std::nullopt;
+
+        const auto policy = it->get<std::string>();
+        if (policy == "none") return Settings::Cache::Policy::NONE;
+        if (policy == "lazy") return Settings::Cache::Policy::LAZY;
+        if (policy == "aggressive") return Settings::Cache::Policy::AGGRESSIVE;
+
+        throw std::runtime_error {
+            std::format("Unknown cache policy \"{}\" for {}", policy, entity)
+        };
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Settings::load(const std::filesystem::path &path) -> Settings {
+    auto file = std::ifstream { path };
+    if (!file) throw std::runtime_error { std::format("Failed to open {}", path.string()) };
+
+    const auto document = json::parse(file);
+
+    auto settings            = Settings {};
+    settings.token           = document.at("token").get<std::string>();
+    settings.enabled_plugins = document.at("enabled_plugins").get<std::vector<std::string>>();
+
+    if (document.contains("record_events"))
+        settings.record_events = document["record_events"].get<std::string>();
+
+    if (document.contains("session_file"))
+        settings.session_file = document["session_file"].get<std::string>();
+
+    settings.metrics_port = document.value("metrics_port", settings.metrics_port);
+    settings.message_cache_budget =
+        document.value("message_cache_budget", settings.message_cache_budget);
+
+    if (document.contains("tracing")) {
+        const auto &tracing           = document["tracing"];
+        settings.tracing.enabled      = tracing.value("enabled", settings.tracing.enabled);
+        settings.tracing.sample_every = tracing.value("sample_every", settings.tracing.sample_every);
+        settings.tracing.buffer_size  = tracing.value("buffer_size", settings.tracing.buffer_size);
+    }
+
+    if (document.contains("gateway")) {
+        const auto &gateway          = document["gateway"];
+        settings.gateway.compression = gateway.value("compression", settings.gateway.compression);
+        settings.gateway.measure     = gateway.value("measure", settings.gateway.measure);
+    }
+
+    if (document.contains("downloads")) {
+        const auto &downloads   = document["downloads"];
+        auto &parsed            = settings.downloads;
+        parsed.parallel         = std::max(downloads.value("parallel", parsed.parallel), 1u);
+        parsed.host_connections = downloads.value("host_connections", parsed.host_connections);
+        parsed.max_size         = downloads.value("max_size", parsed.max_size);
+        parsed.timeout =
+            std::chrono::milliseconds { downloads.value("timeout_ms", parsed.timeout.count()) };
+        parsed.connect_timeout = std::chrono::milliseconds {
+            downloads.value("connect_timeout_ms", parsed.connect_timeout.count())
+        };
+    }
+
+    if (document.contains("cache")) {
+        const auto &cache       = document["cache"];
+        settings.cache.users  = parseCachePolicy(cache, "users");
+        settings.cache.roles  = parseCachePolicy(cache, "roles");
+        settings.cache.emojis = parseCachePolicy(cache, "emojis");
+        settings.cache.budget = cache.value("budget", settings.cache.budget);
+    }
+
+    if (document.contains("sharding")) {
+        const auto &sharding       = document["sharding"];
+        settings.sharding.shards   = sharding.value("shards", settings.sharding.shards);
+        settings.sharding.clusters = std::max(sharding.value("clusters", 1u), 1u);
+    }
+
+    for (const auto &enabled_plugin : settings.enabled_plugins) {
+        auto options = json::object();
+
+        if (document.contains(enabled_plugin)) options = document[enabled_plugin];
+
+        settings.plugin_options.emplace(enabled_plugin, std::move(options));
+    }
+
+    return settings;
+}
@@ -0,0 +1,87 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Parsed settings.json, published as an immutable snapshot and replaced as a whole on reload
+struct Settings {
+    static constexpr auto PATH = "settings.json";
+
+    struct Sharding {
+        // 0 uses the shard count recommended by discord
+        stormkit::core::UInt32 shards = 0;
+        // more than one cluster runs every cluster in its own supervised process
+        stormkit::core::UInt32 clusters = 1;
+    };
+
+    struct Tracing {
+        bool enabled                        = false;
+        stormkit::core::UInt32 sample_every = 1;
+        // applied on restart only
+        std::size_t buffer_size = 65536;
+    };
+
+    // dpp 9 always negotiates the json encoding
+    struct Gateway {
+        // zlib-stream transport compression
+        bool compression = true;
+        // logs inbound bytes and decode time per event type, see GatewayStats
+        bool measure = false;
+    };
+
+    // dpp caches, applied on restart only
+    struct Cache {
+        enum class Policy {
+            NONE,
+            // only what arrives with the events
+            LAZY,
+            AGGRESSIVE,
+        };
+
+        // std::nullopt derives the policy from PluginInterface::caches()
+        std::optional<Policy> users;
+        std::optional<Policy> roles;
+        std::optional<Policy> emojis;
+
+        // approximate bytes, the cached members of the largest guilds are dropped above it. 0
+        // disables the budget
+        std::size_t budget = 0;
+    };
+
+    // core downloader shared by the plugins, see Downloader. Applied on restart only
+    struct Downloads {
+        // transfers running at once, the others wait in the queue
+        stormkit::core::UInt32 parallel = 8;
+        // connections kept alive per host
+        stormkit::core::UInt32 host_connections = 4;
+        // upper bounds, requests can only lower them
+        std::size_t max_size                      = 32 * 1024 * 1024;
+        std::chrono::milliseconds timeout         = std::chrono::seconds { 30 };
+        std::chrono::milliseconds connect_timeout = std::chrono::seconds { 10 };
+    };
+
+    std::string token;
+    Sharding sharding;
+    Cache cache;
+    Tracing tracing;
+    // applied on restart only
+    Gateway gateway;
+    Downloads downloads;
+    // gateway sessions are saved there to be resumed on restart, see SessionStore. Clusters
+    // other than the first one insert their id before the extension. Empty disables it
+    std::filesystem::path session_file = "session.json";
+    // gateway dispatch events are appended to this file, see EventLog
+    std::optional<std::filesystem::path> record_events;
+    // latency percentiles are served on 127.0.0.1:metrics_port, 0 disables the endpoint
+    stormkit::core::UInt16 metrics_port = 0;
+    // approximate memory budget of the message cache in bytes, 0 disables it. Applied on restart
+    std::size_t message_cache_budget = 16 * 1024 * 1024;
+    std::vector<std::string> enabled_plugins;
+    stormkit::core::HashMap<std::string, nlohmann::json> plugin_options;
+
+    // throws if the file can't be parsed or misses a required entry
+    [[nodiscard]] static auto load(const std::filesystem::path &path = PATH) -> Settings;
+};
@@ -0,0 +1,28 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Immutable values read by the dpp event threads. Readers hold the version they loaded for as
+// long as they use it, a replaced version is freed once its last reader releases it.
+template<typename T>
+class Snapshot {
+  public:
+    auto publish(T value) -> std::shared_ptr<const T> {
+        auto published = std::make_shared<const T>(std::move(value));
+
+        m_current.store(published, std::memory_order_release);
+
+        return published;
+    }
+
+    [[nodiscard]] auto get() const noexcept -> std::shared_ptr<const T> {
+        return m_current.load(std::memory_order_acquire);
+    }
+
+  private:
+    std::atomic<std::shared_ptr<const T>> m_current;
+};
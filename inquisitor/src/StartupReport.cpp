@@ -0,0 +1,74 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "StartupReport.hpp"
+
+namespace {
+    auto toMilliseconds(std::chrono::steady_clock::duration duration) -> double {
+        return std::chrono::duration<double, std::milli> { duration }.count();
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+StartupReport::StartupReport() noexcept : m_origin { Clock::now() } {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto StartupReport::await(std::size_t spans) -> void {
+    auto lock = std::unique_lock { m_mutex };
+    m_awaited = spans;
+
+    if (spans == 0 && !m_logged) {
+        m_logged = true;
+        log();
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto StartupReport::record(std::string_view phase,
+                           std::string_view subject,
+                           Clock::time_point start,
+                           bool awaited) -> void {
+    const auto end = Clock::now();
+
+    auto lock = std::unique_lock { m_mutex };
+    if (m_logged) return;
+
+    m_spans.emplace_back(
+        Span { std::string { phase }, std::string { subject }, start - m_origin, end - start });
+
+    if (!awaited || !m_awaited) return;
+
+    if (*m_awaited > 0) --*m_awaited;
+    if (*m_awaited > 0) return;
+
+    m_logged = true;
+    log();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto StartupReport::log() const -> void {
+    if (std::empty(m_spans)) return;
+
+    auto spans = m_spans;
+    std::ranges::sort(spans, {}, &Span::offset);
+
+    const auto total = std::ranges::max(spans, {}, [](const auto &span) {
+        return span.offset + span.duration;
+    });
+
+    ilog("Started in {:.1f}ms", toMilliseconds(total.offset + total.duration));
+
+    for (const auto &span : spans)
+        ilog("  {:>9.1f}ms +{:>9.1f}ms  {}{}{}",
+             toMilliseconds(span.offset),
+             toMilliseconds(span.duration),
+             span.phase,
+             std::empty(span.subject) ? "" : " ",
+             span.subject);
+}
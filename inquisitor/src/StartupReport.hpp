@@ -0,0 +1,42 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Wall time of every startup phase, and of every plugin in the per plugin phases. Phases overlap,
+// each span is logged with its offset from the start of the process. The report is logged once
+// all the awaited spans ended
+class StartupReport {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    StartupReport() noexcept;
+
+    // number of spans recorded with awaited set before the report is logged
+    auto await(std::size_t spans) -> void;
+    // the span ends now, subject is empty for a whole phase
+    auto record(std::string_view phase,
+                std::string_view subject,
+                Clock::time_point start,
+                bool awaited = false) -> void;
+
+  private:
+    struct Span {
+        std::string phase;
+        std::string subject;
+        Clock::duration offset;
+        Clock::duration duration;
+    };
+
+    auto log() const -> void;
+
+    Clock::time_point m_origin;
+
+    std::mutex m_mutex;
+    std::vector<Span> m_spans;
+    std::optional<std::size_t> m_awaited;
+    bool m_logged = false;
+};
@@ -0,0 +1,145 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Supervisor.hpp"
+
+#if defined(__linux__)
+    #include <csignal>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+using namespace stormkit;
+using namespace std::literals;
+
+namespace {
+    // a worker exiting sooner than this is considered crashing and is restarted with a backoff
+    constexpr auto MIN_UPTIME  = 30s;
+    constexpr auto MIN_BACKOFF = 1s;
+    constexpr auto MAX_BACKOFF = 60s;
+    constexpr auto STOP_POLL   = 100ms;
+
+#if defined(__linux__)
+    volatile std::sig_atomic_t g_stop = 0;
+
+    auto onStopSignal(int) -> void {
+        g_stop = 1;
+    }
+#endif
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+Supervisor::Supervisor(core::UInt32 clusters, Worker worker)
+    : m_worker { std::move(worker) }, m_processes(clusters, Process { .backoff = MIN_BACKOFF }) {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Supervisor::run() -> int {
+#if defined(__linux__)
+    // no SA_RESTART, waitpid has to return on SIGINT / SIGTERM
+    struct sigaction action = {};
+    action.sa_handler       = onStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    ilog("Supervising {} clusters", std::size(m_processes));
+
+    for (auto i = 0u; i < std::size(m_processes); ++i) spawn(i);
+
+    auto alive    = std::size(m_processes);
+    auto stopping = false;
+
+    while (alive > 0) {
+        if (g_stop && !stopping) {
+            ilog("Stopping the workers");
+            stopping = true;
+
+            for (const auto &process : m_processes)
+                if (process.pid > 0) kill(process.pid, SIGTERM);
+        }
+
+        auto status    = 0;
+        const auto pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+
+            elog("waitpid failed, reason: {}", std::strerror(errno));
+            return EXIT_FAILURE;
+        }
+
+        const auto it = std::ranges::find(m_processes, pid, &Process::pid);
+        if (it == std::ranges::end(m_processes)) continue;
+
+        const auto cluster_id =
+            static_cast<core::UInt32>(std::distance(std::ranges::begin(m_processes), it));
+        it->pid = -1;
+
+        if (WIFSIGNALED(status))
+            wlog("Cluster {} killed by signal {}", cluster_id, WTERMSIG(status));
+        else
+            ilog("Cluster {} exited with code {}", cluster_id, WEXITSTATUS(status));
+
+        if (stopping || (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS)) {
+            --alive;
+            continue;
+        }
+
+        if (Clock::now() - it->started_at < MIN_UPTIME) {
+            wlog("Cluster {} is crashing, restarting it in {}s",
+                 cluster_id,
+                 std::chrono::duration_cast<std::chrono::seconds>(it->backoff).count());
+
+            // cut short by SIGINT / SIGTERM, the other workers are stopped on the next iteration
+            const auto restart_at = Clock::now() + it->backoff;
+            while (!g_stop && Clock::now() < restart_at) std::this_thread::sleep_for(STOP_POLL);
+
+            it->backoff = std::min<Clock::duration>(it->backoff * 2, MAX_BACKOFF);
+        } else
+            it->backoff = MIN_BACKOFF;
+
+        if (g_stop) {
+            --alive;
+            continue;
+        }
+
+        spawn(cluster_id);
+    }
+
+    return EXIT_SUCCESS;
+#else
+    elog("Running {} clusters needs process support, only available on Linux",
+         std::size(m_processes));
+
+    return EXIT_FAILURE;
+#endif
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Supervisor::spawn([[maybe_unused]] core::UInt32 cluster_id) -> void {
+#if defined(__linux__)
+    auto &process = m_processes[cluster_id];
+
+    const auto pid = fork();
+    if (pid < 0) {
+        elog("Failed to fork cluster {}, reason: {}", cluster_id, std::strerror(errno));
+        return;
+    }
+
+    if (pid == 0) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+
+        std::exit(m_worker(cluster_id));
+    }
+
+    ilog("Cluster {} started (pid {})", cluster_id, pid);
+
+    process.pid        = pid;
+    process.started_at = Clock::now();
+#endif
+}
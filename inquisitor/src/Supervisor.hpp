@@ -0,0 +1,32 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Forks one worker process per cluster and restarts the ones which fail, a worker exiting with
+// EXIT_SUCCESS is done. Must run before any thread is created, the workers are forked without
+// exec. Linux only, run() fails elsewhere
+class Supervisor {
+  public:
+    using Clock  = std::chrono::steady_clock;
+    using Worker = std::function<int(stormkit::core::UInt32 cluster_id)>;
+
+    Supervisor(stormkit::core::UInt32 clusters, Worker worker);
+
+    auto run() -> int;
+
+  private:
+    struct Process {
+        int pid = -1;
+        Clock::time_point started_at;
+        Clock::duration backoff;
+    };
+
+    auto spawn(stormkit::core::UInt32 cluster_id) -> void;
+
+    Worker m_worker;
+    std::vector<Process> m_processes;
+};
@@ -0,0 +1,251 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#include "Tracer.hpp"
+
+using namespace stormkit;
+
+namespace {
+    // every slice shares it, so a viewer keeps the slices of a trace together
+    constexpr auto CATEGORY = "inquisitor";
+
+    thread_local Tracer::TraceID t_current        = 0;
+    thread_local Tracer::SliceID t_current_parent = 0;
+
+    std::atomic<core::UInt32> g_next_thread = 1;
+    thread_local const auto t_thread        = g_next_thread.fetch_add(1, std::memory_order_relaxed);
+
+    template<std::size_t N>
+    auto copyTruncated(std::string_view from, std::array<char, N> &to) noexcept -> void {
+        const auto size = std::min(std::size(from), N - 1);
+
+        std::ranges::copy(from.substr(0, size), std::begin(to));
+        to[size] = '\0';
+    }
+} // namespace
+
+/////////////////////////////////////
+/////////////////////////////////////
+Tracer::Slice::Slice(Tracer &tracer,
+                     TraceID trace,
+                     SliceID parent,
+                     std::string_view kind,
+                     std::string_view name)
+    : m_tracer { &tracer }, m_trace { trace },
+      m_id { tracer.m_next_slice.fetch_add(1, std::memory_order_relaxed) }, m_name { name } {
+    auto event   = Event {};
+    event.phase  = 'b';
+    event.trace  = m_trace;
+    event.id     = m_id;
+    event.parent = parent;
+    copyTruncated(kind, event.kind);
+    copyTruncated(m_name, event.name);
+
+    m_tracer->record(event);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Tracer::Slice::~Slice() {
+    end();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Tracer::Slice::Slice(Slice &&other) noexcept
+    : m_tracer { std::exchange(other.m_tracer, nullptr) }, m_trace { other.m_trace },
+      m_id { other.m_id }, m_name { std::move(other.m_name) } {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::Slice::operator=(Slice &&other) noexcept -> Slice & {
+    if (this == &other) return *this;
+
+    end();
+
+    m_tracer = std::exchange(other.m_tracer, nullptr);
+    m_trace  = other.m_trace;
+    m_id     = other.m_id;
+    m_name   = std::move(other.m_name);
+
+    return *this;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::Slice::id() const noexcept -> SliceID {
+    return m_tracer ? m_id : 0;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::Slice::end() noexcept -> void {
+    if (!m_tracer) return;
+
+    auto event  = Event {};
+    event.phase = 'e';
+    event.trace = m_trace;
+    event.id    = m_id;
+    copyTruncated(m_name, event.name);
+
+    m_tracer->record(event);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Tracer::Context::Context(TraceID trace, SliceID parent) noexcept
+    : m_previous_trace { std::exchange(t_current, trace) },
+      m_previous_parent { std::exchange(t_current_parent, parent) } {
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Tracer::Context::~Context() {
+    t_current        = m_previous_trace;
+    t_current_parent = m_previous_parent;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+Tracer::Tracer(std::size_t capacity)
+    : m_epoch { Clock::now() }, m_events(std::max<std::size_t>(capacity, 1)) {
+    m_writer = std::jthread { [this](std::stop_token token) { write(std::move(token)); } };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::configure(bool enabled, core::UInt32 sample_every) noexcept -> void {
+    m_sample_every.store(std::max(sample_every, 1u), std::memory_order_relaxed);
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::enabled() const noexcept -> bool {
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::startTrace() noexcept -> TraceID {
+    if (!enabled()) return 0;
+
+    const auto n = m_started.fetch_add(1, std::memory_order_relaxed);
+    if (n % m_sample_every.load(std::memory_order_relaxed) != 0) return 0;
+
+    return n + 1;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::slice(TraceID trace, SliceID parent, std::string_view kind, std::string_view name)
+    -> Slice {
+    if (trace == 0) return {};
+
+    return Slice { *this, trace, parent, kind, name };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::dump(std::filesystem::path path, OnDump on_dump) -> void {
+    auto events = [this] {
+        auto lock = std::unique_lock { m_mutex };
+
+        const auto count = std::min(m_next, std::size(m_events));
+        auto events      = std::vector<Event> {};
+        events.reserve(count);
+
+        for (auto i = m_next - count; i < m_next; ++i)
+            events.emplace_back(m_events[i % std::size(m_events)]);
+
+        return events;
+    }();
+
+    {
+        auto lock = std::unique_lock { m_dumps_mutex };
+        m_dumps.emplace_back(Dump { std::move(path), std::move(events), std::move(on_dump) });
+    }
+
+    m_dumps_wake.notify_one();
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::current() noexcept -> TraceID {
+    return t_current;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::currentSlice() noexcept -> SliceID {
+    return t_current_parent;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::record(Event event) -> void {
+    if (event.trace == 0) return;
+
+    event.timestamp =
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_epoch).count();
+    event.thread = t_thread;
+
+    auto lock                                = std::unique_lock { m_mutex };
+    m_events[m_next++ % std::size(m_events)] = event;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::write(std::stop_token token) -> void {
+    while (!token.stop_requested()) {
+        auto lock = std::unique_lock { m_dumps_mutex };
+        if (!m_dumps_wake.wait(lock, token, [this] { return !std::empty(m_dumps); })) break;
+
+        auto dump = std::move(m_dumps.front());
+        m_dumps.pop_front();
+        lock.unlock();
+
+        dump.on_dump(write(dump));
+    }
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto Tracer::write(const Dump &dump) -> bool {
+    auto trace_events = nlohmann::json::array();
+    for (const auto &event : dump.events) {
+        auto trace_event = nlohmann::json {
+            { "name", std::data(event.name) },
+            { "cat", CATEGORY },
+            { "ph", std::string(1, event.phase) },
+            { "id", std::format("{:#x}", event.id) },
+            { "ts", event.timestamp },
+            { "pid", 1 },
+            { "tid", event.thread },
+        };
+
+        if (event.phase == 'b')
+            trace_event["args"] = {
+                { "kind", std::data(event.kind) },
+                { "trace", std::format("{:#x}", event.trace) },
+                { "parent", std::format("{:#x}", event.parent) },
+            };
+
+        trace_events.emplace_back(std::move(trace_event));
+    }
+
+    auto file = std::ofstream { dump.path };
+    file << nlohmann::json { { "traceEvents", std::move(trace_events) },
+                             { "displayTimeUnit", "ms" } };
+
+    if (!file) {
+        elog("Failed to write trace {}", dump.path.string());
+        return false;
+    }
+
+    ilog("Trace of {} events written to {}", std::size(dump.events), dump.path.string());
+
+    return true;
+}
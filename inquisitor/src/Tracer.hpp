@@ -0,0 +1,119 @@
+// Copryright (C) 2023 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#pragma once
+
+#include "CoreDependencies.hpp"
+
+// Records gateway events, plugin callbacks and REST calls as chrome trace async slices in a
+// fixed size ring buffer, dump() writes what it holds in the chrome://tracing / Perfetto JSON
+// format. Every slice has its own id and records the one of its parent and of its trace, the
+// gateway event it was made for. A trace id of 0 means not traced.
+class Tracer {
+  public:
+    using Clock   = std::chrono::steady_clock;
+    using TraceID = stormkit::core::UInt64;
+    using SliceID = stormkit::core::UInt64;
+    using OnDump  = std::function<void(bool written)>;
+
+    // ends the slice when destroyed
+    class Slice {
+      public:
+        Slice() noexcept = default;
+        Slice(Tracer &tracer,
+              TraceID trace,
+              SliceID parent,
+              std::string_view kind,
+              std::string_view name);
+        ~Slice();
+
+        Slice(const Slice &)                    = delete;
+        auto operator=(const Slice &) -> Slice & = delete;
+
+        Slice(Slice &&other) noexcept;
+        auto operator=(Slice &&other) noexcept -> Slice &;
+
+        // 0 when not traced
+        [[nodiscard]] auto id() const noexcept -> SliceID;
+
+      private:
+        auto end() noexcept -> void;
+
+        Tracer *m_tracer = nullptr;
+        TraceID m_trace  = 0;
+        SliceID m_id     = 0;
+        std::string m_name;
+    };
+
+    // makes trace and parent the ones of the calling thread until destroyed
+    class Context {
+      public:
+        Context(TraceID trace, SliceID parent) noexcept;
+        ~Context();
+
+        Context(const Context &)                    = delete;
+        auto operator=(const Context &) -> Context & = delete;
+
+      private:
+        TraceID m_previous_trace;
+        SliceID m_previous_parent;
+    };
+
+    explicit Tracer(std::size_t capacity);
+
+    // only one gateway event out of sample_every is traced
+    auto configure(bool enabled, stormkit::core::UInt32 sample_every) noexcept -> void;
+    [[nodiscard]] auto enabled() const noexcept -> bool;
+
+    [[nodiscard]] auto startTrace() noexcept -> TraceID;
+    // parent is 0 for the root slice of the trace
+    [[nodiscard]] auto
+        slice(TraceID trace, SliceID parent, std::string_view kind, std::string_view name)
+            -> Slice;
+
+    // the events held now are written from the tracer thread, which calls on_dump afterward
+    auto dump(std::filesystem::path path, OnDump on_dump) -> void;
+
+    [[nodiscard]] static auto current() noexcept -> TraceID;
+    [[nodiscard]] static auto currentSlice() noexcept -> SliceID;
+
+  private:
+    struct Event {
+        std::array<char, 48> name;
+        std::array<char, 24> kind;
+        char phase;
+        TraceID trace;
+        SliceID id;
+        SliceID parent;
+        stormkit::core::Int64 timestamp;
+        stormkit::core::UInt32 thread;
+    };
+
+    struct Dump {
+        std::filesystem::path path;
+        std::vector<Event> events;
+        OnDump on_dump;
+    };
+
+    auto record(Event event) -> void;
+    auto write(std::stop_token token) -> void;
+    static auto write(const Dump &dump) -> bool;
+
+    std::atomic_bool m_enabled                         = false;
+    std::atomic<stormkit::core::UInt32> m_sample_every = 1;
+    std::atomic<TraceID> m_started                     = 0;
+    std::atomic<SliceID> m_next_slice                  = 1;
+
+    Clock::time_point m_epoch;
+
+    mutable std::mutex m_mutex;
+    std::vector<Event> m_events;
+    std::size_t m_next = 0;
+
+    std::mutex m_dumps_mutex;
+    std::condition_variable_any m_dumps_wake;
+    std::deque<Dump> m_dumps;
+
+    std::jthread m_writer;
+};
@@ -4,12 +4,37 @@
 
 #include "CoreDependencies.hpp"
 #include "Inquisitor.hpp"
+#include "Settings.hpp"
+#include "Supervisor.hpp"
+
+#include <csignal>
+
+namespace {
+    volatile std::sig_atomic_t g_stop = 0;
+
+    auto onStopSignal(int) -> void {
+        g_stop = 1;
+    }
+} // namespace
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto main(const int argc, const char **argv) -> int {
+static auto runCluster(stormkit::core::UInt32 cluster_id, const int argc, const char **argv)
+    -> int {
+    // SIGINT / SIGTERM stop the cluster gracefully, the supervisor forwards SIGTERM to it
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
     try {
-        auto inquisitor = Inquisitor {};
+        auto inquisitor = Inquisitor { cluster_id };
+
+        auto stopper = std::jthread { [&inquisitor](std::stop_token token) {
+            while (!g_stop && !token.stop_requested())
+                std::this_thread::sleep_for(std::chrono::milliseconds { 50 });
+
+            if (g_stop) inquisitor.stop();
+        } };
+
         inquisitor.run(argc, argv);
     } catch (const std::exception &e) {
         flog("Unhandled exception, {}", e.what());
@@ -18,3 +43,24 @@ auto main(const int argc, const char **argv) -> int {
 
     return EXIT_SUCCESS;
 }
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto main(const int argc, const char **argv) -> int {
+    auto clusters = stormkit::core::UInt32 { 1 };
+
+    try {
+        clusters = Settings::load().sharding.clusters;
+    } catch (const std::exception &e) {
+        flog("Failed to load {}, {}", Settings::PATH, e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (clusters == 1) return runCluster(0, argc, argv);
+
+    auto supervisor = Supervisor { clusters, [argc, argv](auto cluster_id) {
+                                      return runCluster(cluster_id, argc, argv);
+                                  } };
+
+    return supervisor.run();
+}
@@ -68,20 +68,35 @@ auto BasePlugin::commands() const -> std::vector<Command> {
     };
 }
 
+/////////////////////////////////////
+/////////////////////////////////////
+auto BasePlugin::subscription() const -> Subscription {
+    return Subscription{ .events = Subscription::READY };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto BasePlugin::intents() const -> stormkit::core::UInt32 {
+    // commands come through interactions, which don't need any intent
+    return 0;
+}
+
 /////////////////////////////////////
 /////////////////////////////////////
 auto BasePlugin::onReady([[maybe_unused]] const dpp::ready_t &event, dpp::cluster &bot) -> void {
     const auto str =  std::format("-- :robot: Inquisitor V{}.{} initialized :robot: --", m_major_version, m_minor_version);
 
-    for(const auto &id : m_channels) {
-        auto id_as_snowflake = static_cast<dpp::snowflake>(std::stoll(id));
-        bot.message_create(dpp::message{id_as_snowflake, str});
-    }
+    for(const auto id : m_channels)
+        m_core->sendRequest("message_create", CoreServices::Priority::HOUSEKEEPING, [&bot, message = dpp::message{id, str}](auto callback) {
+            bot.message_create(message, std::move(callback));
+        }, [](const auto &result) {
+            if(result.is_error()) elog("{}", result.http_info.body);
+        }, id);
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto BasePlugin::onCommand(const dpp::interaction_create_t &event, [[maybe_unused]] dpp::cluster &bot) -> void {
+auto BasePlugin::onCommand(const dpp::interaction_create_t &event, [[maybe_unused]] dpp::cluster &bot) -> Task<> {
     auto cmd_data = std::get<dpp::command_interaction>(event.command.data);
 
     if(cmd_data.name == "help")
@@ -90,6 +105,14 @@ auto BasePlugin::onCommand(const dpp::interaction_create_t &event, [[maybe_unuse
         sendPlugins(event);
     else if(cmd_data.name == "about")
         sendAbout(event);
+
+    return {};
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto BasePlugin::describeOptions(OptionSchema &schema) -> void {
+    schema.snowflakes("channels", m_channels);
 }
 
 /////////////////////////////////////
@@ -98,8 +121,6 @@ auto BasePlugin::initialize(const json& options) -> void {
     m_major_version = options["inquisitor"]["major"].get<stormkit::core::UInt32>();
     m_minor_version = options["inquisitor"]["minor"].get<stormkit::core::UInt32>();
 
-    m_channels = options["channels"].get<std::vector<std::string>>();
-
     static constexpr auto PLUGIN_FORMAT = "🔵 **{}** \n";
 
     m_help_string = "";
@@ -131,7 +152,7 @@ auto BasePlugin::sendHelp(const dpp::interaction_create_t& event) -> void {
     auto message = dpp::message{}
                        .add_embed(std::move(embed));
 
-    event.reply(dpp::ir_channel_message_with_source, std::move(message));
+    m_core->reply(event, std::move(message));
 }
 
 /////////////////////////////////////
@@ -149,7 +170,7 @@ auto BasePlugin::sendPlugins(const dpp::interaction_create_t& event) -> void {
     auto message = dpp::message{}
                        .add_embed(std::move(embed));
 
-    event.reply(dpp::ir_channel_message_with_source, std::move(message));
+    m_core->reply(event, std::move(message));
 }
 
 /////////////////////////////////////
@@ -167,5 +188,5 @@ auto BasePlugin::sendAbout(const dpp::interaction_create_t &event) -> void {
     auto message = dpp::message{}
                        .add_embed(std::move(embed));
 
-    event.reply(dpp::ir_channel_message_with_source, std::move(message));
+    m_core->reply(event, std::move(message));
 }
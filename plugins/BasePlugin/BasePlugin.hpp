@@ -20,11 +20,14 @@ class BasePlugin final: public PluginInterface {
 
     [[nodiscard]] std::string_view name() const override;
     [[nodiscard]] std::vector<Command> commands() const override;
+    [[nodiscard]] Subscription subscription() const override;
+    [[nodiscard]] stormkit::core::UInt32 intents() const override;
 
     void onReady(const dpp::ready_t &, dpp::cluster &) override;
-    void onCommand(const dpp::interaction_create_t &, dpp::cluster &) override;
+    Task<> onCommand(const dpp::interaction_create_t &, dpp::cluster &) override;
 
   protected:
+    void describeOptions(OptionSchema &schema) override;
     void initialize(const json &options) override;
 
   private:
@@ -35,7 +38,7 @@ class BasePlugin final: public PluginInterface {
     stormkit::core::UInt32 m_major_version;
     stormkit::core::UInt32 m_minor_version;
 
-    std::vector<std::string> m_channels;
+    SnowflakeSet m_channels;
 
     std::string m_help_string;
     std::string m_plugins_string;
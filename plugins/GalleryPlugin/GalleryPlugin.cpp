@@ -17,12 +17,9 @@
 
 INQUISITOR_PLUGIN(GalleryPlugin)
 
-static constexpr auto REGEX = R"(https?:\/\/(www\.)?[-a-zA-Z0-9@:%._\+~#=]{1,256}\.[a-zA-Z0-9()]{1,6}\b([-a-zA-Z0-9()@:%_\+.~#?&//=]*))";
-
 /////////////////////////////////////
 /////////////////////////////////////
-GalleryPlugin::GalleryPlugin() noexcept
-    : m_regex{REGEX, std::regex::ECMAScript | std::regex::optimize | std::regex::icase} {}
+GalleryPlugin::GalleryPlugin() noexcept = default;
 
 /////////////////////////////////////
 /////////////////////////////////////
@@ -42,43 +39,37 @@ auto GalleryPlugin::commands() const -> std::vector<Command> {
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto GalleryPlugin::initialize(const json &options) -> void {
-    if(!options.contains("channels")) {
-        elog("Missing channels array in options");
-        return;
-    }
-
-    if(!options["channels"].is_array()) {
-        elog("Option entry \"channels\" array need to be an array");
-        return;
-    }
-
-    m_channels = options["channels"].get<std::vector<std::string>>();
+auto GalleryPlugin::subscription() const -> Subscription {
+    return Subscription{ .events = Subscription::MESSAGE, .channels = m_channels.ids() };
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto GalleryPlugin::onMessageReceived(const dpp::message_create_t &event, dpp::cluster &bot) -> void {
-    auto it = std::ranges::find_if(m_channels, [channel_id = event.msg->channel_id](const auto &channel){ return channel == std::to_string(channel_id); });
-
-    if(it == std::ranges::end(m_channels)) return;
+auto GalleryPlugin::intents() const -> stormkit::core::UInt32 {
+    return dpp::i_guild_messages | dpp::i_message_content;
+}
 
-    const auto &message = *event.msg;
+/////////////////////////////////////
+/////////////////////////////////////
+auto GalleryPlugin::describeOptions(OptionSchema &schema) -> void {
+    schema.snowflakes("channels", m_channels);
+}
 
-    auto matches = std::smatch{};
-    const auto has_url = std::regex_search(message.content, matches, m_regex);
+/////////////////////////////////////
+/////////////////////////////////////
+auto GalleryPlugin::initialize([[maybe_unused]] const json &options) -> void {
+    m_core->messageScanner().enable(MessageScanner::URLS);
+}
 
-    if(std::empty(message.attachments) && message.author->id != bot.me.id && !has_url) {
-        bot.message_delete(message.id, message.channel_id, [](const auto &event){
-                if(event.is_error()) elog("{}", event.http_info.body);
-        });
+/////////////////////////////////////
+/////////////////////////////////////
+auto GalleryPlugin::onMessage(const MessageView &message, dpp::cluster &bot) -> Task<> {
+    if(std::empty(message.attachments) && !message.own_message && !message.has_url) {
+        m_core->deleteMessage(message.id, message.channel_id);
 
-        return;
+        co_return;
     }
 
-    const auto name = (std::empty(message.member.nickname)) ?
-        message.author->username : message.member.nickname;
-
     auto now = std::chrono::system_clock::now();
 #if __cpp_lib_chrono >= 201907L
     auto tp = std::chrono::zoned_time{std::chrono::current_zone(), now}.get_local_time();
@@ -98,12 +89,14 @@ auto GalleryPlugin::onMessageReceived(const dpp::message_create_t &event, dpp::c
     auto y = utc_tm.tm_year + 1900;
 #endif
 
-    bot.thread_create_with_message(
-        std::format("galerie-{}-{}/{}/{}", name, d, m, y),
-        message.channel_id,
-        message.id,
-        1440,
-        [](const auto &event) {
-            if(event.is_error()) elog("{}", event.http_info.body);
+    const auto result = co_await restCall(*m_core, "thread_create_with_message", CoreServices::Priority::HOUSEKEEPING, [&](auto callback) {
+        bot.thread_create_with_message(
+            std::format("galerie-{}-{}/{}/{}", message.author_name, d, m, y),
+            message.channel_id,
+            message.id,
+            1440,
+            std::move(callback));
     });
+
+    if(result.is_error()) elog("{}", result.http_info.body);
 }
@@ -6,7 +6,6 @@
 
 /////////// - STL - ///////////
 #include <string>
-#include <regex>
 
 /////////// - Inquisitor-API - ///////////
 #include <PluginInterface.hpp>
@@ -18,13 +17,14 @@ class GalleryPlugin final: public PluginInterface {
 
     [[nodiscard]] std::string_view name() const override;
     [[nodiscard]] std::vector<Command> commands() const override;
+    [[nodiscard]] Subscription subscription() const override;
+    [[nodiscard]] stormkit::core::UInt32 intents() const override;
 
-    void onMessageReceived(const dpp::message_create_t &, dpp::cluster &) override;
+    Task<> onMessage(const MessageView &, dpp::cluster &) override;
   protected:
+    void describeOptions(OptionSchema &schema) override;
     void initialize(const json &options) override;
 
   private:
-    std::regex m_regex;
-
-    std::vector<std::string> m_channels;
+    SnowflakeSet m_channels;
 };
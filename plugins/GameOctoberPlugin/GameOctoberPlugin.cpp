@@ -15,8 +15,6 @@ INQUISITOR_PLUGIN(GameOctoberPlugin)
 
 using namespace std::literals;
 
-static constexpr auto REGEX = R"(https?:\/\/(www\.)?[-a-zA-Z0-9@:%._\+~#=]{1,256}\.[a-zA-Z0-9()]{1,6}\b([-a-zA-Z0-9()@:%_\+.~#?&//=]*))";
-
 static constexpr auto THEMES = std::array {
     "Cristal"sv,
     "Costume"sv,
@@ -53,8 +51,7 @@ static constexpr auto THEMES = std::array {
 
 /////////////////////////////////////
 /////////////////////////////////////
-GameOctoberPlugin::GameOctoberPlugin() noexcept
-    : m_regex{REGEX, std::regex::ECMAScript | std::regex::optimize | std::regex::icase} {}
+GameOctoberPlugin::GameOctoberPlugin() noexcept = default;
 
 /////////////////////////////////////
 /////////////////////////////////////
@@ -74,18 +71,31 @@ auto GameOctoberPlugin::commands() const -> std::vector<Command> {
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto GameOctoberPlugin::initialize(const json &options) -> void {
-    if(!options.contains("channel")) {
-        elog("Missing channels array in options");
-        return;
-    }
+auto GameOctoberPlugin::subscription() const -> Subscription {
+    if(m_channel_id.empty()) return Subscription{ .events = Subscription::READY };
 
-    if(!options["channel"].is_string()) {
-        elog("Option entry \"channels\" array need to be an array");
-        return;
-    }
+    return Subscription{
+        .channels = std::vector{ m_channel_id },
+        .ignore_own_messages = true
+    };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto GameOctoberPlugin::intents() const -> stormkit::core::UInt32 {
+    return dpp::i_guild_messages | dpp::i_message_content;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto GameOctoberPlugin::describeOptions(OptionSchema &schema) -> void {
+    schema.snowflake("channel", m_channel_id);
+}
 
-    m_channel_id = static_cast<dpp::snowflake>(std::stoll(options["channel"].get<std::string>()));
+/////////////////////////////////////
+/////////////////////////////////////
+auto GameOctoberPlugin::initialize([[maybe_unused]] const json &options) -> void {
+    m_core->messageScanner().enable(MessageScanner::URLS);
 }
 
 /////////////////////////////////////
@@ -113,13 +123,16 @@ auto GameOctoberPlugin::onReady(const dpp::ready_t &event, dpp::cluster &bot) ->
 #endif
         if(m == 10 && h == 0 && min == 0) {
             std::cout << m_current_word << std::endl;
-                bot.message_create(dpp::message {
+                m_core->sendRequest("message_create", CoreServices::Priority::HOUSEKEEPING, [&bot, message = dpp::message {
                         m_channel_id,
                         std::format("A vos claviers ! Le thème du jour est \"{}\".", THEMES[m_current_word++])
+                    }](auto callback) {
+                        bot.message_create(message, std::move(callback));
                     },
                     [](const auto &event){
                         if(event.is_error()) elog("{}", event.http_info.body);
-                    }
+                    },
+                    m_channel_id
                 );
             m_started = true;
         }
@@ -128,19 +141,15 @@ auto GameOctoberPlugin::onReady(const dpp::ready_t &event, dpp::cluster &bot) ->
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto GameOctoberPlugin::onMessageReceived(const dpp::message_create_t &event, dpp::cluster &bot) -> void {
+auto GameOctoberPlugin::onMessageReceived(const dpp::message_create_t &event, const MessageScanner::Matches &matches, dpp::cluster &bot) -> Task<> {
     const auto &message = *event.msg;
-    if(message.author->id == bot.me.id || message.channel_id != m_channel_id) return;
 
-    auto matches = std::smatch{};
-    const auto has_url = std::regex_search(message.content, matches, m_regex);
+    const auto has_url = !std::empty(matches.urls);
 
     if(std::empty(message.attachments) && !has_url) {
-        bot.message_delete(message.id, message.channel_id, [](const auto &event){
-                if(event.is_error()) elog("{}", event.http_info.body);
-        });
+        m_core->deleteMessage(message.id, message.channel_id);
 
-        return;
+        return {};
     }
 
     const auto name = (std::empty(message.member.nickname)) ?
@@ -161,12 +170,12 @@ auto GameOctoberPlugin::onMessageReceived(const dpp::message_create_t &event, dp
     auto d = utc_tm.tm_mday;
 #endif
     if(m_started)
-    bot.thread_create_with_message(
-        std::format("{}-{}-{}-gameoctober-2021", THEMES[m_current_word - 1u], name, d),
-        m_channel_id,
-        message.id,
-        1440,
+    m_core->sendRequest("thread_create_with_message", CoreServices::Priority::HOUSEKEEPING, [&bot, thread_name = std::format("{}-{}-{}-gameoctober-2021", THEMES[m_current_word - 1u], name, d), channel_id = m_channel_id, message_id = message.id](auto callback) {
+            bot.thread_create_with_message(thread_name, channel_id, message_id, 1440, std::move(callback));
+        },
         [](const auto &event) {
             if(event.is_error()) elog("{}", event.http_info.body);
-    });
+    }, m_channel_id);
+
+    return {};
 }
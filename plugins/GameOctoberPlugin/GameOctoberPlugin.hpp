@@ -6,7 +6,6 @@
 
 /////////// - STL - ///////////
 #include <string>
-#include <regex>
 #include <chrono>
 #include <atomic>
 
@@ -23,15 +22,16 @@ class GameOctoberPlugin final: public PluginInterface {
 
     [[nodiscard]] std::string_view name() const override;
     [[nodiscard]] std::vector<Command> commands() const override;
+    [[nodiscard]] Subscription subscription() const override;
+    [[nodiscard]] stormkit::core::UInt32 intents() const override;
 
     void onReady(const dpp::ready_t &, dpp::cluster &) override;
-    void onMessageReceived(const dpp::message_create_t &, dpp::cluster &) override;
+    Task<> onMessageReceived(const dpp::message_create_t &, const MessageScanner::Matches &, dpp::cluster &) override;
   protected:
+    void describeOptions(OptionSchema &schema) override;
     void initialize(const json &options) override;
 
   private:
-    std::regex m_regex;
-
     dpp::snowflake m_channel_id;
 
     std::atomic<std::size_t> m_current_word = 0;
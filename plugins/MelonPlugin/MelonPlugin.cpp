@@ -9,12 +9,11 @@
 
 INQUISITOR_PLUGIN(MelonPlugin)
 
-static constexpr auto REGEX = R"(melon)";
+static constexpr auto KEYWORD = "melon";
 
 /////////////////////////////////////
 /////////////////////////////////////
-MelonPlugin::MelonPlugin() noexcept
-    : m_regex{REGEX, std::regex::ECMAScript | std::regex::optimize | std::regex::icase} {}
+MelonPlugin::MelonPlugin() noexcept = default;
 
 /////////////////////////////////////
 /////////////////////////////////////
@@ -34,11 +33,28 @@ auto MelonPlugin::commands() const -> std::vector<Command> {
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto MelonPlugin::onMessageReceived(const dpp::message_create_t &event, dpp::cluster &bot) -> void {
-    auto matches = std::smatch{};
-    const auto &content = event.msg->content;
+auto MelonPlugin::initialize([[maybe_unused]] const json &options) -> void {
+    m_keyword = m_core->messageScanner().addKeyword(KEYWORD);
+}
 
-    if(!std::regex_search(content, matches, m_regex)) return;
+/////////////////////////////////////
+/////////////////////////////////////
+auto MelonPlugin::subscription() const -> Subscription {
+    return Subscription{ .events = Subscription::MESSAGE };
+}
 
-    bot.message_add_reaction(*event.msg, "🍈");
+/////////////////////////////////////
+/////////////////////////////////////
+auto MelonPlugin::intents() const -> stormkit::core::UInt32 {
+    return dpp::i_guild_messages | dpp::i_message_content;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto MelonPlugin::onMessage(const MessageView &message, [[maybe_unused]] dpp::cluster &bot) -> Task<> {
+    if(!message.matches->contains(m_keyword)) return {};
+
+    m_core->addReaction(*message.event->msg, "🍈");
+
+    return {};
 }
@@ -9,12 +9,9 @@
 
 INQUISITOR_PLUGIN(QuoteMessagePlugin)
 
-static constexpr auto REGEX = R"(https?:\/\/discord.com\/channels\/([[:digit:]]+)\/([[:digit:]]+)\/([[:digit:]]+))";
-
 /////////////////////////////////////
 /////////////////////////////////////
-QuoteMessagePlugin::QuoteMessagePlugin() noexcept
-    : m_regex{REGEX, std::regex::ECMAScript | std::regex::optimize | std::regex::icase} {}
+QuoteMessagePlugin::QuoteMessagePlugin() noexcept = default;
 
 /////////////////////////////////////
 /////////////////////////////////////
@@ -34,43 +31,66 @@ auto QuoteMessagePlugin::commands() const -> std::vector<Command> {
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto QuoteMessagePlugin::onMessageReceived(const dpp::message_create_t &event, dpp::cluster &bot) -> void {
-    auto matches = std::smatch{};
-    const auto &content = event.msg->content;
+auto QuoteMessagePlugin::initialize([[maybe_unused]] const json &options) -> void {
+    m_core->messageScanner().enable(MessageScanner::MESSAGE_LINKS);
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto QuoteMessagePlugin::subscription() const -> Subscription {
+    return Subscription{ .events = Subscription::MESSAGE };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto QuoteMessagePlugin::intents() const -> stormkit::core::UInt32 {
+    return dpp::i_guild_messages | dpp::i_message_content;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto QuoteMessagePlugin::onMessage(const MessageView &quoting, dpp::cluster &bot) -> Task<> {
+    if(std::empty(quoting.matches->message_links)) co_return;
 
-    if(!std::regex_search(content, matches, m_regex)) return;
+    const auto &link = quoting.matches->message_links.front();
 
-    const auto guild_id = event.msg->guild_id;
+    auto cached = m_core->cachedMessage(link.message_id);
+    if(!cached) {
+        const auto result = co_await restCall(*m_core, "message_get", [&](auto callback) {
+            bot.message_get(link.message_id, link.channel_id, std::move(callback));
+        });
 
-    const auto channel_id = static_cast<dpp::snowflake>(std::stoll(matches[2].str()));
-    const auto message_id = static_cast<dpp::snowflake>(std::stoll(matches[3].str()));
+        if(result.is_error()) {
+            elog("{}", result.get_error().message);
+            co_return;
+        }
 
-    const auto target_channel_id = event.msg->channel_id;
+        cached = std::make_shared<const dpp::message>(std::get<dpp::message>(result.value));
+        m_core->cacheMessage(*cached);
+    }
 
-    bot.message_get(message_id, channel_id, [&bot, guild_id, content, target_channel_id](const auto &event){
-        if(event.is_error())
-            elog("{}", event.get_error().message);
-        else {
-            const auto &message = std::get<dpp::message>(event.value);
+    const auto &message = *cached;
 
-            if(message.guild_id != guild_id) return;
+    if(message.guild_id != quoting.guild_id) co_return;
 
-            const auto name = (std::empty(message.member.nickname)) ?
-                  message.author->username : message.member.nickname;
+    const auto name = (std::empty(message.member.nickname)) ?
+          message.author->username : message.member.nickname;
 
-            auto author = dpp::embed_author{
-                .name = name,
-                .url  = std::format("https://discordapp.com/users/{}", message.author->id),
-                .icon_url = message.author->get_avatar_url()
-            };
+    auto author = dpp::embed_author{
+        .name = name,
+        .url  = std::format("https://discordapp.com/users/{}", message.author->id),
+        .icon_url = message.author->get_avatar_url()
+    };
 
-            auto embed = dpp::embed{}
-                .set_description(message.content)
-                .set_author(std::move(author));
+    auto embed = dpp::embed{}
+        .set_description(message.content)
+        .set_author(std::move(author));
 
-            auto reply = dpp::message{target_channel_id, std::move(embed)};
+    auto reply = dpp::message{quoting.channel_id, std::move(embed)};
 
-            bot.message_create(reply);
-        }
+    const auto sent = co_await restCall(*m_core, "message_create", [&](auto callback) {
+        bot.message_create(reply, std::move(callback));
     });
+
+    if(sent.is_error()) elog("{}", sent.get_error().message);
 }
@@ -6,7 +6,6 @@
 
 /////////// - STL - ///////////
 #include <string>
-#include <regex>
 
 /////////// - Inquisitor-API - ///////////
 #include <PluginInterface.hpp>
@@ -18,8 +17,11 @@ class QuoteMessagePlugin final: public PluginInterface {
 
     [[nodiscard]] std::string_view name() const override;
     [[nodiscard]] std::vector<Command> commands() const override;
+    [[nodiscard]] Subscription subscription() const override;
+    [[nodiscard]] stormkit::core::UInt32 intents() const override;
 
-    void onMessageReceived(const dpp::message_create_t &, dpp::cluster &) override;
-  private:
-    std::regex m_regex;
+    Task<> onMessage(const MessageView &, dpp::cluster &) override;
+
+  protected:
+    void initialize(const json &options) override;
 };
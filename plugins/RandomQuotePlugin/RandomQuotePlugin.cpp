@@ -10,6 +10,17 @@
 #include <iostream>
 #include <chrono>
 
+#if defined(__linux__)
+/////////// - POSIX - ///////////
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
 /////////// - StormKit::core - ///////////
 #include <storm/core/Strings.hpp>
 
@@ -21,25 +32,58 @@ using namespace std::literals;
 /////////////////////////////////////
 RandomQuotePlugin::RandomQuotePlugin()
     : m_generator{std::random_device{}()}, m_send_distribution{0, 100}, m_quote_distribution{0, 1} {
-    auto stream = std::ifstream{};
-    stream.open("facts.txt");
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+RandomQuotePlugin::~RandomQuotePlugin() {
+#if defined(__linux__)
+    if(!std::empty(m_facts)) munmap(const_cast<char *>(std::data(m_facts)), std::size(m_facts));
+#endif
+}
 
-    if(!stream) {
+/////////////////////////////////////
+/////////////////////////////////////
+auto RandomQuotePlugin::prepare() -> void {
+#if defined(__linux__)
+    const auto fd = open("facts.txt", O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
         elog("Failed to open facts.txt");
         return;
     }
 
-    const auto string =
-        std::string { std::istreambuf_iterator<char> { stream }, std::istreambuf_iterator<char> {} };
+    struct stat info = {};
+    const auto size = (fstat(fd, &info) == 0) ? static_cast<std::size_t>(info.st_size) : std::size_t { 0 };
 
-    m_quote_list = stormkit::core::split(string, '\n');
+    auto *data = (size > 0) ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
 
-    m_quote_distribution = std::uniform_int_distribution<stormkit::core::UInt32>{0, gsl::narrow_cast<stormkit::core::UInt32>(std::size(m_quote_list))};
-}
+    if(data == MAP_FAILED) {
+        elog("Failed to map facts.txt");
+        return;
+    }
 
-/////////////////////////////////////
-/////////////////////////////////////
-RandomQuotePlugin::~RandomQuotePlugin() = default;
+    m_facts = { static_cast<const char *>(data), size };
+#else
+    auto file = std::ifstream { "facts.txt", std::ios::binary };
+    if(!file) {
+        elog("Failed to open facts.txt");
+        return;
+    }
+
+    m_facts_copy = std::string { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+    m_facts      = m_facts_copy;
+#endif
+
+    for(auto line : std::views::split(std::string_view { std::data(m_facts), std::size(m_facts) }, '\n')) {
+        if(std::ranges::empty(line)) continue;
+
+        m_quote_list.emplace_back(std::data(line), std::ranges::size(line));
+    }
+
+    if(!std::empty(m_quote_list))
+        m_quote_distribution = std::uniform_int_distribution<stormkit::core::UInt32>{0, gsl::narrow_cast<stormkit::core::UInt32>(std::size(m_quote_list) - 1)};
+}
 
 /////////////////////////////////////
 /////////////////////////////////////
@@ -58,24 +102,38 @@ auto RandomQuotePlugin::commands() const -> std::vector<Command> {
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto RandomQuotePlugin::onCommand(const dpp::interaction_create_t &event, [[maybe_unused]] dpp::cluster &bot) -> void {
+auto RandomQuotePlugin::subscription() const -> Subscription {
+    return Subscription{ .events = Subscription::MESSAGE, .channels = m_channels.ids() };
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RandomQuotePlugin::intents() const -> stormkit::core::UInt32 {
+    return dpp::i_guild_messages;
+}
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto RandomQuotePlugin::onCommand(const dpp::interaction_create_t &event, [[maybe_unused]] dpp::cluster &bot) -> Task<> {
     auto quote = getQuote();
 
     if(!std::empty(quote))
-        event.reply(dpp::ir_channel_message_with_source, dpp::message{quote});
+        m_core->reply(event, dpp::message{quote});
+
+    return {};
 }
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto RandomQuotePlugin::onMessageReceived(const dpp::message_create_t &event, dpp::cluster &bot) -> void {
-    auto it = std::ranges::find_if(m_last_sended_messages, [&event](const auto &p) { return p.first == std::to_string(event.msg->channel_id); });
-    if(it == std::ranges::cend(m_last_sended_messages)) return;
+auto RandomQuotePlugin::onMessage(const MessageView &message, dpp::cluster &bot) -> Task<> {
+    auto it = m_last_sended_messages.find(static_cast<std::uint64_t>(message.channel_id));
+    if(it == std::ranges::end(m_last_sended_messages)) return {};
 
     auto now = Clock::now();
 
-    auto &tp = m_last_sended_messages[it->first];
+    auto &tp = it->second;
 
-    if(std::chrono::duration_cast<std::chrono::seconds>(now - tp) < 10min) return;
+    if(std::chrono::duration_cast<std::chrono::seconds>(now - tp) < m_cooldown) return {};
 
     tp = now;
 
@@ -85,30 +143,37 @@ auto RandomQuotePlugin::onMessageReceived(const dpp::message_create_t &event, dp
         auto quote = getQuote();
 
         if(!std::empty(quote))
-            bot.message_create(dpp::message{event.msg->channel_id, quote});
+            m_core->sendRequest("message_create", CoreServices::Priority::HOUSEKEEPING, [&bot, reply = dpp::message{message.channel_id, quote}](auto callback) {
+                bot.message_create(reply, std::move(callback));
+            }, [](const auto &result) {
+                if(result.is_error()) elog("{}", result.http_info.body);
+            }, message.channel_id);
     }
+
+    return {};
 }
 
 
 /////////////////////////////////////
 /////////////////////////////////////
-auto RandomQuotePlugin::initialize(const json &options) -> void {
-    if(!options.contains("channels")) {
-        elog("Missing channels array in options");
-        return;
-    }
+auto RandomQuotePlugin::describeOptions(OptionSchema &schema) -> void {
+    schema.snowflakes("channels", m_channels)
+          .duration("cooldown", m_cooldown, OptionSchema::Presence::OPTIONAL);
+}
 
-    if(!options["channels"].is_array()) {
-        elog("Option entry \"channels\" array need to be an array");
-        return;
-    }
+/////////////////////////////////////
+/////////////////////////////////////
+auto RandomQuotePlugin::initialize([[maybe_unused]] const json &options) -> void {
+    m_last_sended_messages.clear();
 
-    m_channels = options["channels"].get<std::vector<std::string>>();
+    for(const auto channel : m_channels)
+        m_last_sended_messages[static_cast<std::uint64_t>(channel)] = Clock::now();
+}
 
-    for(const auto &channel : m_channels) {
-        ilog("{}", channel);
-        m_last_sended_messages[channel] = Clock::now();
-    }
+/////////////////////////////////////
+/////////////////////////////////////
+auto RandomQuotePlugin::onConfigChanged([[maybe_unused]] const json &old_options, const json &new_options) -> void {
+    initialize(new_options);
 }
 
 /////////////////////////////////////
@@ -118,5 +183,5 @@ auto RandomQuotePlugin::getQuote() -> std::string {
 
     auto quote_n = m_quote_distribution(m_generator);
 
-    return m_quote_list[quote_n];
+    return std::string { m_quote_list[quote_n] };
 }
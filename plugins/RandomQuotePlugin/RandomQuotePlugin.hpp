@@ -7,6 +7,7 @@
 /////////// - STL - ///////////
 #include <string>
 #include <string_view>
+#include <span>
 #include <random>
 #include <chrono>
 
@@ -24,11 +25,17 @@ class RandomQuotePlugin final: public PluginInterface {
 
     [[nodiscard]] std::string_view name() const override;
     [[nodiscard]] std::vector<Command> commands() const override;
+    [[nodiscard]] Subscription subscription() const override;
+    [[nodiscard]] stormkit::core::UInt32 intents() const override;
 
-    void onCommand(const dpp::interaction_create_t &, dpp::cluster &) override;
-    void onMessageReceived(const dpp::message_create_t &, dpp::cluster &) override;
+    void prepare() override;
+
+    Task<> onCommand(const dpp::interaction_create_t &, dpp::cluster &) override;
+    Task<> onMessage(const MessageView &, dpp::cluster &) override;
+    void onConfigChanged(const json &old_options, const json &new_options) override;
 
   protected:
+    void describeOptions(OptionSchema &schema) override;
     void initialize(const json &options) override;
 
   private:
@@ -40,9 +47,14 @@ class RandomQuotePlugin final: public PluginInterface {
     std::uniform_int_distribution<stormkit::core::UInt32> m_send_distribution;
     std::uniform_int_distribution<stormkit::core::UInt32> m_quote_distribution;
 
-    std::vector<std::string> m_channels;
+    SnowflakeSet m_channels;
+    std::chrono::seconds m_cooldown = std::chrono::minutes { 10 };
 
-    std::vector<std::string> m_quote_list;
+    // facts.txt is mapped read only, so the cluster processes share its pages. Read into
+    // m_facts_copy where mmap isn't available
+    std::span<const char> m_facts;
+    std::string m_facts_copy;
+    std::vector<std::string_view> m_quote_list;
 
-    stormkit::core::HashMap<std::string, Clock::time_point> m_last_sended_messages;
+    stormkit::core::HashMap<std::uint64_t, Clock::time_point> m_last_sended_messages;
 };
@@ -92,9 +92,8 @@ TEXTURES
 
 SHADER_SOURCE)"sv;
 
-//static constexpr auto REGEX = R"(```glsl\n([[:alnum:]]+)\n```)";
-static constexpr auto GLSL_REGEX = R"(```glsl\n([a-zA-Z0-9\n\r\t^,:{}\[\]\-\.+=*$&\-\_%?\/" \(\);<>!]+)\n```)";
-static constexpr auto JSON_REGEX = R"(```json\n([a-zA-Z0-9\n\r\t^,:{}\[\]\-\.+=*$&\-\_%?\/" \(\);<>!]+)\n```)";
+static constexpr auto GLSL_BLOCK = CodeBlock<"glsl"> {};
+static constexpr auto JSON_BLOCK = CodeBlock<"json"> {};
 
 struct Vertex {
     core::Vector2f position;
@@ -166,9 +165,15 @@ static auto seekVideo(void *opaque, std::int64_t pos, int whence) -> std::int64_
 
 /////////////////////////////////////
 /////////////////////////////////////
-ShaderPlugin::ShaderPlugin()
-    : m_glsl_regex{GLSL_REGEX, std::regex::ECMAScript | std::regex::optimize | std::regex::icase},
-      m_json_regex{JSON_REGEX, std::regex::ECMAScript | std::regex::optimize | std::regex::icase} {
+ShaderPlugin::ShaderPlugin() = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+ShaderPlugin::~ShaderPlugin() = default;
+
+/////////////////////////////////////
+/////////////////////////////////////
+auto ShaderPlugin::prepare() -> void {
     ilog("Initialization of render backend");
     m_instance = std::make_unique<Instance>();
     ilog("Success");
@@ -222,13 +227,8 @@ ShaderPlugin::ShaderPlugin()
 
     ilog("Initializing ffmpeg");
     m_avformat_context.reset(avformat_alloc_context());
-
 }
 
-/////////////////////////////////////
-/////////////////////////////////////
-ShaderPlugin::~ShaderPlugin() = default;
-
 /////////////////////////////////////
 /////////////////////////////////////
 auto ShaderPlugin::name() const -> std::string_view {
@@ -305,11 +305,10 @@ auto ShaderPlugin::initialize(const json &options) -> void {
 /////////////////////////////////////
 /////////////////////////////////////
 auto ShaderPlugin::getAttachedGlsl(const json &msg) const -> std::optional<std::string> {
-    const auto content = msg["content"].get<std::string>();
-    auto matches = std::smatch{};
+    const auto &content = msg["content"].get_ref<const std::string &>();
 
-    if(std::regex_search(content, matches, m_glsl_regex))
-        return matches[1].str();
+    if(const auto glsl = GLSL_BLOCK.find(content); glsl)
+        return std::string{*glsl};
 
     if(!msg.contains("attachments")) return std::nullopt;
 
@@ -322,7 +321,13 @@ auto ShaderPlugin::getAttachedGlsl(const json &msg) const -> std::optional<std::
             if(ext == "glsl")  {
                 const auto url = attachment["proxy_url"].get<std::string>();
 
-                return getHttpFile(fmt::format("https://cdn.discordapp.com/{}", std::string_view{url}.substr(29)));
+                auto result = m_core->download({.url = fmt::format("https://cdn.discordapp.com/{}", std::string_view{url}.substr(29))}).get();
+                if(!result.ok()) {
+                    elog("Failed to download {}, reason: {} (status {})", url, result.error, result.status);
+                    return std::nullopt;
+                }
+
+                return std::move(result.body);
             }
         }
 
@@ -332,18 +337,42 @@ auto ShaderPlugin::getAttachedGlsl(const json &msg) const -> std::optional<std::
     return std::nullopt;
 }
 
+/////////////////////////////////////
+/////////////////////////////////////
+auto ShaderPlugin::downloadTextures(const std::vector<std::string> &urls) const -> std::vector<std::string> {
+    // every texture is in flight before waiting on the first one
+    auto downloads = std::vector<std::future<CoreServices::DownloadResult>>{};
+    downloads.reserve(std::size(urls));
+    for(const auto &url : urls) {
+        ilog("Downloading texture {}", url);
+        downloads.emplace_back(m_core->download({.url = url}));
+    }
+
+    auto files = std::vector<std::string>{};
+    files.reserve(std::size(urls));
+    for(auto i = 0u; i < std::size(downloads); ++i) {
+        auto result = downloads[i].get();
+        if(!result.ok())
+            elog("Failed to download {}, reason: {} (status {})", urls[i], result.error, result.status);
+
+        files.emplace_back(result.ok() ? std::move(result.body) : std::string{});
+    }
+
+    return files;
+}
+
 /////////////////////////////////////
 /////////////////////////////////////
 auto ShaderPlugin::getAttachedJson(const json &msg) const -> std::optional<json> {
-    const auto content = msg["content"].get<std::string>();
-    auto matches = std::smatch{};
+    const auto &content = msg["content"].get_ref<const std::string &>();
 
-    if(!std::regex_search(content, matches, m_json_regex)) return std::nullopt;
+    const auto body = JSON_BLOCK.find(content);
+    if(!body) return std::nullopt;
 
-    if(!json::accept(matches[1].str()))
+    if(!json::accept(*body))
         return json{};
 
-    return json::parse(matches[1].str());
+    return json::parse(*body);
 }
 
 /////////////////////////////////////
@@ -417,16 +446,17 @@ auto ShaderPlugin::singleFrame(std::vector<std::string> textures, std::string_vi
     auto opt_string = fmt::format("Options: \n```textures:\n{}\nframe_count: {}\nextent:\n    width: {},\n    height: {}```", textures_str, 1u, extent.width, extent.height);
     content = fmt::format(":white_check_mark: Compilation success! :white_check_mark:\n{}", opt_string);
 
+    const auto files = downloadTextures(textures);
+
     auto textures_ = std::vector<image::Image>{};
     textures_.reserve(std::size(textures));
-    for(const auto &texture : textures) {
-        ilog("Downloading texture {}", texture);
-        auto file = getHttpFile(texture);
-        dlog("file downloaded");
+    for(auto j = 0u; j < std::size(textures); ++j) {
+        const auto &texture = textures[j];
+        const auto &file = files[j];
 
         auto data = core::toConstByteSpan(file);
 
-        if(std::empty(texture)) {
+        if(std::empty(file)) {
             content += fmt::format("Failed to get image file {}\n", texture);
             continue;
         }
@@ -515,15 +545,17 @@ auto ShaderPlugin::multipleFrame(std::vector<std::string> textures, core::UInt32
     auto opt_string = fmt::format("Options: \n```textures:\n{}\nfps: {}\nframe_count: {}\nextent:\n    width: {},\n    height: {}```", textures_str, fps, frame_count, extent.width, extent.height);
     content = fmt::format(":white_check_mark: Compilation success! :white_check_mark:\n{}", opt_string);
 
+    const auto files = downloadTextures(textures);
+
     auto textures_ = std::vector<image::Image>{};
     textures_.reserve(std::size(textures));
-    for(const auto &texture : textures) {
-        ilog("Downloading texture {}", texture);
-        auto file = getHttpFile(texture);
+    for(auto j = 0u; j < std::size(textures); ++j) {
+        const auto &texture = textures[j];
+        const auto &file = files[j];
 
         auto data = core::toConstByteSpan(file);
 
-        if(std::empty(texture)) {
+        if(std::empty(file)) {
             content += fmt::format("Failed to get image file {}\n", texture);
             continue;
         }
@@ -10,11 +10,11 @@
 #include <random>
 #include <chrono>
 #include <vector>
-#include <regex>
 #include <span>
 
 /////////// - Inquisitor-API - ///////////
 #include <PluginInterface.hpp>
+#include <inquisitor/CodeBlock.hpp>
 
 /////////// - StormKit::core - ///////////
 #include <storm/core/Types.hpp>
@@ -47,6 +47,8 @@ class ShaderPlugin final: public PluginInterface {
     [[nodiscard]] std::string_view help() const override;
     void onCommand(std::string_view command, const json &msg) override;
 
+    void prepare() override;
+
   protected:
     void initialize(const json &options) override;
 
@@ -55,9 +57,7 @@ class ShaderPlugin final: public PluginInterface {
 
     std::optional<std::string> getAttachedGlsl(const json &msg) const;
     std::optional<json> getAttachedJson(const json &msg) const;
-
-    std::regex m_glsl_regex;
-    std::regex m_json_regex;
+    std::vector<std::string> downloadTextures(const std::vector<std::string> &urls) const;
 
     std::optional<std::pair<std::string, std::string>> compileShader(std::string_view glsl, std::vector<stormkit::render::SpirvID> &output, std::size_t texture_count);
 
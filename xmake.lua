@@ -72,7 +72,9 @@ if has_config("use_modules") then
 end
 
 add_repositories("localrepo thirdparty")
-add_requires("frozen", "unordered_dense", "glm", "libcurl", "dpp", "nlohmann_json", {debug = is_mode("debug")})
+add_requires("frozen", "unordered_dense", "glm", "libcurl", "nlohmann_json", {debug = is_mode("debug")})
+-- the core and the plugins use the dpp 9 API (pointer event fields, cluster::start(bool))
+add_requires("dpp v9.0.19", {debug = is_mode("debug")})
 
 local stormkit_configs = {
     enable_log = true
@@ -91,5 +93,12 @@ option("use_cpp23_msvc_import")
 option("enable_pch")
     set_default(true)
 
+option("enable_benchmarks")
+    set_default(false)
+
 includes("api/xmake.lua")
 includes("inquisitor/xmake.lua")
+
+if has_config("enable_benchmarks") then
+    includes("benchmarks/xmake.lua")
+end